@@ -0,0 +1,80 @@
+#include "Engine/pch.h"
+#include "Engine/Core/Atlas.h"
+
+#include "SDL_image.h"
+
+static void PrintUsage() {
+    cout << "usage: Atlas OUTPUT IMAGE|DIRECTORY... [options]\n"
+         << "  OUTPUT                  the table to write, the pages are written beside it\n"
+         << "  IMAGE|DIRECTORY         images to pack, every .png of a directory but the output's pages\n"
+         << "  --page-size N           width and height of a page (2048)\n"
+         << "  --padding N             transparent pixels around every image (1)\n";
+}
+
+static bool ParseNumber(const string& text, int& value) {
+    stringstream stream(text);
+    return (stream >> value) && stream.eof() && value >= 0;
+}
+
+int main(int argc, char** argv) {
+    string output {};
+    vector<string> images {};
+    int pageSize = 2048;
+    int padding = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const string argument = argv[i];
+
+        if (argument == "--page-size" && i + 1 < argc) {
+            if (!ParseNumber(argv[++i], pageSize) || !pageSize) {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (argument == "--padding" && i + 1 < argc) {
+            if (!ParseNumber(argv[++i], padding)) {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (argument[0] == '-') {
+            PrintUsage();
+            return EXIT_FAILURE;
+        } else if (output.empty()) {
+            output = argument;
+        } else if (is_directory(argument)) {
+            // sorted, so baking the same directory twice gives the same atlas, and without
+            // the pages of the output, which a previous bake may have left in it
+            vector<string> directory {};
+            for (const auto& entry : directory_iterator(argument)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".png" && !Atlas::IsPage(entry.path().string(), output)) {
+                    directory.push_back(entry.path().string());
+                }
+            }
+
+            sort(directory.begin(), directory.end());
+            images.insert(images.end(), directory.begin(), directory.end());
+        } else {
+            images.push_back(argument);
+        }
+    }
+
+    if (output.empty() || images.empty()) {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+
+    if (!IMG_Init(IMG_INIT_PNG)) {
+        cout << "SDL_image could not be initialized! Error: " << IMG_GetError() << ".\n";
+        return EXIT_FAILURE;
+    }
+
+    const auto isBuilt = Atlas::Build(images, output, pageSize, padding);
+    IMG_Quit();
+
+    if (!isBuilt) {
+        cout << "The atlas \"" << output << "\" could not be built!\n";
+        return EXIT_FAILURE;
+    }
+
+    cout << "Packed " << images.size() << " images into \"" << output << "\".\n";
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
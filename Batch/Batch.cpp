@@ -0,0 +1,147 @@
+#include "Engine/pch.h"
+
+#include "Engine/Utility/Memory.h"
+#include "Engine/Utility/Stopwatch.h"
+#include "Engine/Utility/ThreadPool.h"
+
+#include "Game/Generation/DungeonFile.h"
+
+#include "Batch.h"
+
+#include <iomanip>
+
+Batch::Batch(
+    const vector<Configuration>& configurations,
+    const uint64_t seedFirst,
+    const size_t seedCount,
+    const size_t threads,
+    const string& directory /* = {} */
+)
+    : mConfigurations(configurations),
+    mSeedFirst(seedFirst),
+    mSeedCount(seedCount),
+    mThreads(max<size_t>(threads, 1)),
+    mDirectory(directory) {}
+
+bool Batch::Run() {
+    if (!mDirectory.empty()) {
+        error_code error {};
+        create_directories(mDirectory, error);
+
+        if (error) {
+            cout << "The directory \"" << mDirectory << "\" could not be created! Error: " << error.message() << ".\n";
+            return false;
+        }
+    }
+
+    cout << mSeedCount << " seed(s) from " << mSeedFirst << ", " << mThreads << " thread(s), latencies in milliseconds\n";
+    cout << "iterations size        tile  ratio       dungeons/s p50      p90      p99      max      peak MiB MiB/s\n";
+
+    size_t failures = 0;
+    for (const auto& configuration : mConfigurations) {
+        const auto report = RunConfiguration(configuration);
+        failures += report.failures;
+
+        stringstream size {};
+        size << configuration.size.GetX() << 'x' << configuration.size.GetY();
+
+        stringstream ratio {};
+        ratio << configuration.ratioToDiscard.GetX() << 'x' << configuration.ratioToDiscard.GetY();
+
+        cout << left << fixed << setprecision(2)
+             << setw(11) << configuration.iterations
+             << setw(12) << size.str()
+             << setw(6) << configuration.tileSize
+             << setw(12) << ratio.str()
+             << setw(11) << (double)mSeedCount / report.seconds
+             << setw(9) << GetPercentile(report.latencies, 0.5) * 1e3
+             << setw(9) << GetPercentile(report.latencies, 0.9) * 1e3
+             << setw(9) << GetPercentile(report.latencies, 0.99) * 1e3
+             << setw(9) << GetPercentile(report.latencies, 1.) * 1e3
+             << setw(9) << (double)report.memoryPeak / (1 << 20)
+             << (double)report.bytes / (1 << 20) / report.seconds << '\n'
+             << defaultfloat;
+    }
+
+    if (failures) {
+        cout << failures << " dungeon(s) could not be saved!\n";
+    }
+
+    return !failures;
+}
+
+Batch::Report Batch::RunConfiguration(const Configuration& configuration) {
+    Report report {};
+    report.latencies.resize(mSeedCount);
+
+    // a configuration's peak leaves out what the ones before it used
+    Memory::ResetResidentPeak();
+
+    atomic<size_t> bytes {};
+    atomic<size_t> failures {};
+
+    const auto generate = [&](const size_t index) {
+        const auto seed = mSeedFirst + index;
+
+        Stopwatch stopwatch {};
+        const Dungeon dungeon(
+            configuration.iterations,
+            configuration.size,
+            configuration.tileSize,
+            configuration.ratioToDiscard,
+            seed
+        );
+
+        if (!mDirectory.empty()) {
+            const auto file = GetFile(configuration, seed);
+
+            if (DungeonFile::Save(file, dungeon)) {
+                bytes += (size_t)file_size(file);
+            } else {
+                failures++;
+            }
+        }
+
+        report.latencies[index] = stopwatch.GetSeconds();
+    };
+
+    Stopwatch stopwatch {};
+    if (mThreads <= 1 || mSeedCount <= 1) {
+        for (size_t i = 0; i < mSeedCount; i++) {
+            generate(i);
+        }
+    } else {
+        // the calling thread generates dungeons too
+        ThreadPool threadPool(min(mThreads, mSeedCount) - 1);
+        threadPool.ForEach(mSeedCount, generate);
+    }
+    report.seconds = stopwatch.GetSeconds();
+
+    report.memoryPeak = Memory::GetResidentPeak();
+    report.bytes = bytes;
+    report.failures = failures;
+
+    sort(report.latencies.begin(), report.latencies.end());
+    return report;
+}
+
+string Batch::GetFile(const Configuration& configuration, const uint64_t seed) const {
+    stringstream file {};
+    file << "dungeon_i" << configuration.iterations
+         << "_s" << configuration.size.GetX() << 'x' << configuration.size.GetY()
+         << "_t" << configuration.tileSize
+         << "_r" << configuration.ratioToDiscard.GetX() << 'x' << configuration.ratioToDiscard.GetY()
+         << '_' << seed << ".dng";
+
+    return (path(mDirectory) / file.str()).string();
+}
+
+double Batch::GetPercentile(const vector<double>& latencies, const double percentile) {
+    if (latencies.empty()) {
+        return 0.;
+    }
+
+    // nearest rank on the sorted latencies
+    const auto rank = (size_t)ceil(percentile * (double)latencies.size());
+    return latencies[min(max<size_t>(rank, 1), latencies.size()) - 1];
+}
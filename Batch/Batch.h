@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Game/Generation/Dungeon.h"
+
+struct Configuration {
+    size_t iterations {};
+    Point<float> size {};
+    float tileSize {};
+    Point<float> ratioToDiscard {};
+};
+
+// Generates a dungeon for every seed of a range and every configuration of a sweep, one
+// dungeon per core at a time, optionally saving each as a DungeonFile, and prints the
+// throughput, the latency percentiles and the peak memory of every configuration
+class Batch {
+public:
+    Batch(
+        const vector<Configuration>& configurations,
+        const uint64_t seedFirst,
+        const size_t seedCount,
+        const size_t threads,
+        const string& directory = {}
+    );
+
+    // false if any dungeon could not be saved
+    bool Run();
+
+private:
+    struct Report {
+        double seconds {};
+        vector<double> latencies {};
+        size_t memoryPeak {};
+        size_t bytes {};
+        size_t failures {};
+    };
+
+    Report RunConfiguration(const Configuration& configuration);
+
+    string GetFile(const Configuration& configuration, const uint64_t seed) const;
+
+    static double GetPercentile(const vector<double>& latencies, const double percentile);
+
+    vector<Configuration> mConfigurations {};
+    uint64_t mSeedFirst {};
+    size_t mSeedCount {};
+    size_t mThreads {};
+    string mDirectory {};
+};
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "Engine/pch.h"
+#include "Batch.h"
+
+#include <thread>
+
+// the tree holds 2^(iterations + 1) nodes, past this it stops fitting in memory
+static constexpr size_t iterationsMax = 20;
+static constexpr size_t threadsMax = 256;
+
+static void PrintUsage() {
+    cout << "usage: Batch [options]\n"
+         << "  --seeds FIRST[:COUNT]   seeds to generate for every configuration (0:100)\n"
+         << "  --iterations N,...      BSP iterations, 1 to " << iterationsMax << " (4)\n"
+         << "  --size WxH,...          canvas sizes (640x480)\n"
+         << "  --tile-size S,...       tile sizes (10)\n"
+         << "  --ratio R[xR],...       ratios to discard, 0 keeps every cut (0.45)\n"
+         << "  --threads N             worker threads, 1 to " << threadsMax << " (all cores)\n"
+         << "  --output DIRECTORY      saves every dungeon as a dungeon file\n";
+}
+
+// splits "a,b,c" and parses every item with parse, false on the first one it rejects
+template<typename T, typename Parse>
+static bool ParseList(const string& text, vector<T>& values, Parse&& parse) {
+    values.clear();
+
+    stringstream stream(text);
+    string item {};
+    while (getline(stream, item, ',')) {
+        T value {};
+        if (!parse(item, value)) {
+            return false;
+        }
+
+        values.push_back(value);
+    }
+
+    return !values.empty();
+}
+
+// the stream wraps negative numbers around for unsigned types, so their sign is rejected up front
+template<typename T>
+static bool ParseNumber(const string& text, T& value) {
+    if (is_unsigned_v<T> && text.find('-') != string::npos) {
+        return false;
+    }
+
+    stringstream stream(text);
+    return (stream >> value) && stream.eof();
+}
+
+template<typename T>
+static bool ParseNumber(const string& text, T& value, const T& minimum, const T& maximum) {
+    return ParseNumber(text, value) && value >= minimum && value <= maximum;
+}
+
+// "WxH", or a single number for both axes when isSquare, each axis within [minimum, maximum]
+static bool ParsePoint(const string& text, Point<float>& point, const bool isSquare, const float minimum, const float maximum) {
+    const auto separator = text.find('x');
+    if (separator == string::npos) {
+        float value {};
+        if (!isSquare || !ParseNumber(text, value, minimum, maximum)) {
+            return false;
+        }
+
+        point = { value, value };
+        return true;
+    }
+
+    float x {};
+    float y {};
+    if (!ParseNumber(text.substr(0, separator), x, minimum, maximum) ||
+        !ParseNumber(text.substr(separator + 1), y, minimum, maximum)) {
+        return false;
+    }
+
+    point = { x, y };
+    return true;
+}
+
+int main(int argc, char** argv) {
+    uint64_t seedFirst = 0;
+    size_t seedCount = 100;
+    size_t threads = max(thread::hardware_concurrency(), 1u);
+    string directory {};
+
+    vector<size_t> iterations { 4 };
+    vector<Point<float>> sizes { { 640.f, 480.f } };
+    vector<float> tileSizes { 10.f };
+    vector<Point<float>> ratios { { 0.45f, 0.45f } };
+
+    for (int i = 1; i < argc; i++) {
+        const string option = argv[i];
+        if (option == "--help") {
+            PrintUsage();
+            return EXIT_SUCCESS;
+        }
+
+        if (i + 1 >= argc) {
+            cout << "The option \"" << option << "\" is unknown or misses its value!\n";
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+
+        const string value = argv[++i];
+
+        bool isValid = true;
+        if (option == "--seeds") {
+            const auto separator = value.find(':');
+            isValid = ParseNumber(value.substr(0, separator), seedFirst) &&
+                (separator == string::npos || ParseNumber(value.substr(separator + 1), seedCount, (size_t)1, numeric_limits<size_t>::max()));
+        } else if (option == "--iterations") {
+            isValid = ParseList(value, iterations, [](const string& item, size_t& iteration) {
+                return ParseNumber(item, iteration, (size_t)1, iterationsMax);
+            });
+        } else if (option == "--size") {
+            isValid = ParseList(value, sizes, [](const string& item, Point<float>& size) {
+                return ParsePoint(item, size, false, numeric_limits<float>::min(), numeric_limits<float>::max());
+            });
+        } else if (option == "--tile-size") {
+            isValid = ParseList(value, tileSizes, [](const string& item, float& tileSize) {
+                return ParseNumber(item, tileSize, numeric_limits<float>::min(), numeric_limits<float>::max());
+            });
+        } else if (option == "--ratio") {
+            isValid = ParseList(value, ratios, [](const string& item, Point<float>& ratio) {
+                return ParsePoint(item, ratio, true, 0.f, 1.f) && ratio.GetX() < 1.f && ratio.GetY() < 1.f;
+            });
+        } else if (option == "--threads") {
+            isValid = ParseNumber(value, threads, (size_t)1, threadsMax);
+        } else if (option == "--output") {
+            directory = value;
+        } else {
+            cout << "The option \"" << option << "\" is unknown!\n";
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+
+        if (!isValid) {
+            cout << "The value \"" << value << "\" of the option \"" << option << "\" is invalid!\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    vector<Configuration> configurations {};
+    for (const auto iteration : iterations) {
+        for (const auto& size : sizes) {
+            for (const auto tileSize : tileSizes) {
+                for (const auto& ratio : ratios) {
+                    configurations.push_back({ iteration, size, tileSize, ratio });
+                }
+            }
+        }
+    }
+
+    Batch batch(configurations, seedFirst, seedCount, threads, directory);
+    return batch.Run() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
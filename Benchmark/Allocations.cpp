@@ -0,0 +1,137 @@
+#include "Engine/pch.h"
+#include "Benchmark.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions of the whole benchmark executable, so every
+// container growth in the code under test shows up in the counts
+
+static atomic<size_t> allocations {};
+static atomic<size_t> allocatedBytes {};
+
+static void* Allocate(const size_t size) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+
+    return malloc(size ? size : 1);
+}
+
+// MSVC has no aligned_alloc, and its aligned blocks must go back through _aligned_free
+static void* AllocateAligned(const size_t size, const align_val_t alignment) {
+    allocations.fetch_add(1, memory_order_relaxed);
+    allocatedBytes.fetch_add(size, memory_order_relaxed);
+
+    const auto bytes = max<size_t>((size_t)alignment, sizeof(void*));
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, bytes);
+#else
+    // aligned_alloc wants whole multiples of the alignment
+    return aligned_alloc(bytes, ((size ? size : 1) + bytes - 1) / bytes * bytes);
+#endif // _WIN32
+}
+
+static void FreeAligned(void* pointer) {
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    free(pointer);
+#endif // _WIN32
+}
+
+size_t GetAllocations() {
+    return allocations.load(memory_order_relaxed);
+}
+
+size_t GetAllocatedBytes() {
+    return allocatedBytes.load(memory_order_relaxed);
+}
+
+void* operator new(const size_t size) {
+    if (const auto pointer = Allocate(size)) {
+        return pointer;
+    }
+
+    throw bad_alloc();
+}
+
+void* operator new[](const size_t size) {
+    return operator new(size);
+}
+
+void* operator new(const size_t size, const nothrow_t&) noexcept {
+    return Allocate(size);
+}
+
+void* operator new[](const size_t size, const nothrow_t&) noexcept {
+    return Allocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    free(pointer);
+}
+
+void operator delete(void* pointer, const nothrow_t&) noexcept {
+    free(pointer);
+}
+
+void operator delete[](void* pointer, const nothrow_t&) noexcept {
+    free(pointer);
+}
+
+void* operator new(const size_t size, const align_val_t alignment) {
+    if (const auto pointer = AllocateAligned(size, alignment)) {
+        return pointer;
+    }
+
+    throw bad_alloc();
+}
+
+void* operator new[](const size_t size, const align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void* operator new(const size_t size, const align_val_t alignment, const nothrow_t&) noexcept {
+    return AllocateAligned(size, alignment);
+}
+
+void* operator new[](const size_t size, const align_val_t alignment, const nothrow_t&) noexcept {
+    return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* pointer, align_val_t) noexcept {
+    FreeAligned(pointer);
+}
+
+void operator delete[](void* pointer, align_val_t) noexcept {
+    FreeAligned(pointer);
+}
+
+void operator delete(void* pointer, size_t, align_val_t) noexcept {
+    FreeAligned(pointer);
+}
+
+void operator delete[](void* pointer, size_t, align_val_t) noexcept {
+    FreeAligned(pointer);
+}
+
+void operator delete(void* pointer, align_val_t, const nothrow_t&) noexcept {
+    FreeAligned(pointer);
+}
+
+void operator delete[](void* pointer, align_val_t, const nothrow_t&) noexcept {
+    FreeAligned(pointer);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Engine/Utility/Stopwatch.h"
+
+#include "Report.h"
+
+#include <thread>
+
+// Runs function until at least `duration` seconds passed and returns the seconds a single run took on average
+template<typename Function>
+double Measure(Function&& function, const double duration = 0.25) {
+    size_t runs = 0;
+    Stopwatch stopwatch {};
+
+    do {
+        function();
+        runs++;
+    } while (stopwatch.GetSeconds() < duration);
+
+    return stopwatch.GetSeconds() / (double)runs;
+}
+
+// counted by the global operator new since the program started
+size_t GetAllocations();
+
+size_t GetAllocatedBytes();
+
+Report BenchmarkRasterizer();
+
+Report BenchmarkEncoding();
+
+Report BenchmarkStages();
+
+Report BenchmarkPathfinding();
+
+Report BenchmarkFlowField();
\ No newline at end of file
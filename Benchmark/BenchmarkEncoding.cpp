@@ -0,0 +1,62 @@
+#include "Engine/pch.h"
+
+#include "Game/Core/MatrixEncoded.h"
+#include "Game/Generation/Dungeon.h"
+
+#include "Benchmark.h"
+
+Report BenchmarkEncoding() {
+    const pair<size_t, Point<float>> configurations[] = {
+        { 4, { 640.f, 480.f } },
+        { 8, { 2560.f, 1920.f } },
+        { 12, { 10240.f, 7680.f } },
+        { 14, { 20480.f, 15360.f } },
+        { 16, { 40960.f, 30720.f } }
+    };
+
+    Report report(
+        "encoding",
+        "ratio against one byte per tile, million tiles per second",
+        { "iterations", "tiles", "ratio", "packed", "encode", "decode", "row" }
+    );
+
+    for (const auto& configuration : configurations) {
+        const Dungeon dungeon(configuration.first, configuration.second, 10.f, { 0.45f, 0.45f }, 1);
+
+        Matrix<Dungeon::Tile> tileMatrix {};
+        dungeon.GenerateTileMatrix(tileMatrix);
+
+        const auto tiles = (double)(tileMatrix.GetWidth() * tileMatrix.GetHeight());
+        const auto packed = (double)((tileMatrix.GetWidth() + 31) / 32 * 8 * tileMatrix.GetHeight());
+
+        MatrixEncoded<Dungeon::Tile, 2> encoded {};
+        Matrix<Dungeon::Tile> decoded {};
+
+        const auto secondsEncode = Measure([&]() { encoded.Encode(tileMatrix); });
+        const auto secondsDecode = Measure([&]() { encoded.Decode(decoded); });
+
+        if (decoded != tileMatrix) {
+            cerr << "decoded tiles differ for " << configuration.first << " iterations\n";
+            continue;
+        }
+
+        // random access to single rows, as a streaming reader would use it
+        size_t y = 0;
+        const auto secondsRow = Measure([&]() {
+            encoded.DecodeRow(y, decoded[y]);
+            y = (y + 7919) % decoded.GetHeight();
+        });
+
+        report.AddRow({
+            (double)configuration.first,
+            tiles,
+            tiles / (double)encoded.GetSize(),
+            tiles / packed,
+            tiles / secondsEncode / 1e6,
+            tiles / secondsDecode / 1e6,
+            (double)tileMatrix.GetWidth() / secondsRow / 1e6
+        });
+    }
+
+    return report;
+}
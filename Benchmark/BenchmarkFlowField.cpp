@@ -0,0 +1,85 @@
+#include "Engine/pch.h"
+
+#include "Game/Generation/FlowField.h"
+
+#include "Engine/Utility/Random.h"
+
+#include "Benchmark.h"
+
+Report BenchmarkFlowField() {
+    const Point<float> sizes[] = { { 2560.f, 1920.f }, { 10240.f, 7680.f } };
+    vector<size_t> threads = { 1 };
+    if (thread::hardware_concurrency() > 1) {
+        threads.push_back(thread::hardware_concurrency());
+    }
+
+    const size_t goalsCounts[] = { 1, 8 };
+
+    Report report(
+        "flowfield",
+        "milliseconds to fill the field for all goals and to move one goal by a tile",
+        { "width", "height", "threads", "goals", "tiles", "full_ms", "move_ms", "move_region_runs" }
+    );
+
+    for (const auto& size : sizes) {
+        const Dungeon dungeon(12, size, 10.f, { 0.45f, 0.45f }, 1);
+
+        for (const auto threadsCount : threads) {
+            FlowField flowField(dungeon, threadsCount);
+
+            vector<FlowField::Tile> walkable {};
+            for (int32_t y = 0; y < flowField.GetHeight(); y++) {
+                for (int32_t x = 0; x < flowField.GetWidth(); x++) {
+                    if (flowField.IsWalkable({ x, y })) {
+                        walkable.push_back({ x, y });
+                    }
+                }
+            }
+
+            for (const auto goalsCount : goalsCounts) {
+                Random random(1);
+                vector<FlowField::Tile> goals {};
+                for (size_t i = 0; i < goalsCount; i++) {
+                    goals.push_back(walkable[random.GetInteger<size_t>(0, walkable.size() - 1)]);
+                }
+
+                const auto secondsFull = Measure([&]() {
+                    flowField.SetGoals(goals);
+                });
+
+                // the first goal walks back and forth between two tiles, as a player pacing would
+                const auto origin = goals[0];
+                auto other = origin;
+                const FlowField::Tile candidates[] = {
+                    { origin.GetX() + 1, origin.GetY() }, { origin.GetX() - 1, origin.GetY() },
+                    { origin.GetX(), origin.GetY() + 1 }, { origin.GetX(), origin.GetY() - 1 }
+                };
+                for (const auto& candidate : candidates) {
+                    if (flowField.IsWalkable(candidate)) {
+                        other = candidate;
+                        break;
+                    }
+                }
+
+                size_t moves = 0, regionRuns = 0;
+                const auto secondsMove = Measure([&]() {
+                    flowField.MoveGoal(0, moves++ % 2 ? origin : other);
+                    regionRuns += flowField.GetRegionRuns();
+                });
+
+                report.AddRow({
+                    size.GetX(),
+                    size.GetY(),
+                    (double)threadsCount,
+                    (double)goalsCount,
+                    (double)walkable.size(),
+                    secondsFull * 1e3,
+                    secondsMove * 1e3,
+                    round((double)regionRuns / (double)moves)
+                });
+            }
+        }
+    }
+
+    return report;
+}
@@ -0,0 +1,98 @@
+#include "Engine/pch.h"
+
+#include "Game/Generation/Pathfinder.h"
+
+#include "Engine/Utility/Random.h"
+
+#include "Benchmark.h"
+
+Report BenchmarkPathfinding() {
+    const size_t iterations[] = { 8, 12 };
+    const Point<float> sizes[] = { { 2560.f, 1920.f }, { 10240.f, 7680.f } };
+    constexpr size_t pairsCount = 256;
+
+    Report report(
+        "pathfinding",
+        "one thread, queries per second between random reachable tiles, the hierarchical ones refined to tiles",
+        {
+            "iterations", "width", "height", "clusters", "entrances", "build_ms",
+            "flat_qps", "hierarchical_qps", "cached_qps", "length_ratio"
+        }
+    );
+
+    for (const auto iteration : iterations) {
+        for (const auto& size : sizes) {
+            const Dungeon dungeon(iteration, size, 10.f, { 0.45f, 0.45f }, 1);
+
+            Stopwatch stopwatch {};
+            Pathfinder pathfinder(dungeon);
+            const auto secondsBuild = stopwatch.GetSeconds();
+
+            vector<Pathfinder::Tile> walkable {};
+            for (int32_t y = 0; y < (int32_t)dungeon.GetTileMatrixHeight(); y++) {
+                for (int32_t x = 0; x < (int32_t)dungeon.GetTileMatrixWidth(); x++) {
+                    if (pathfinder.IsWalkable({ x, y })) {
+                        walkable.push_back({ x, y });
+                    }
+                }
+            }
+
+            // the flat search settles which pairs are reachable and the lengths to compare against
+            Random random(1);
+            vector<pair<Pathfinder::Tile, Pathfinder::Tile>> pairs {};
+            vector<Pathfinder::Tile> tiles {};
+            size_t lengthFlat = 0;
+
+            for (size_t attempt = 0; attempt < pairsCount * 4 && pairs.size() < pairsCount; attempt++) {
+                const auto& start = walkable[random.GetInteger<size_t>(0, walkable.size() - 1)];
+                const auto& goal = walkable[random.GetInteger<size_t>(0, walkable.size() - 1)];
+
+                if (pathfinder.FindPathFlat(start, goal, tiles)) {
+                    pairs.push_back({ start, goal });
+                    lengthFlat += tiles.size() - 1;
+                }
+            }
+
+            size_t lengthHierarchical = 0;
+            for (const auto& [start, goal] : pairs) {
+                pathfinder.FindPath(start, goal, tiles);
+                lengthHierarchical += tiles.size() - 1;
+            }
+
+            size_t query = 0;
+            const auto secondsFlat = Measure([&]() {
+                const auto& [start, goal] = pairs[query++ % pairs.size()];
+                pathfinder.FindPathFlat(start, goal, tiles);
+            });
+
+            // without the caches every query searches the graph and refines every segment
+            query = 0;
+            const auto secondsHierarchical = Measure([&]() {
+                const auto& [start, goal] = pairs[query++ % pairs.size()];
+                pathfinder.ClearCache();
+                pathfinder.FindPath(start, goal, tiles);
+            });
+
+            query = 0;
+            const auto secondsCached = Measure([&]() {
+                const auto& [start, goal] = pairs[query++ % pairs.size()];
+                pathfinder.FindPath(start, goal, tiles);
+            });
+
+            report.AddRow({
+                (double)iteration,
+                size.GetX(),
+                size.GetY(),
+                (double)pathfinder.GetClusterCount(),
+                (double)pathfinder.GetEntranceCount(),
+                secondsBuild * 1e3,
+                round(1. / secondsFlat),
+                round(1. / secondsHierarchical),
+                round(1. / secondsCached),
+                lengthFlat ? (double)lengthHierarchical / (double)lengthFlat : 1.
+            });
+        }
+    }
+
+    return report;
+}
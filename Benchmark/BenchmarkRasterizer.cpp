@@ -0,0 +1,86 @@
+#include "Engine/pch.h"
+
+#include "Game/Generation/Dungeon.h"
+
+#include "Benchmark.h"
+
+// the loops GenerateTileMatrix ran before it had a rasterizer, kept as the baseline
+static void RasterizeReference(const Dungeon& dungeon, vector<vector<Dungeon::Tile>>& tileMatrix) {
+    const auto tileSize = dungeon.GetTileSize();
+    tileMatrix = vector<vector<Dungeon::Tile>>(dungeon.GetTileMatrixHeight(), vector<Dungeon::Tile>(dungeon.GetTileMatrixWidth(), Dungeon::Tile::NONE));
+
+    for (const auto& path : dungeon.GetPaths()) {
+        if (path.GetRectangle().GetW() == tileSize) {
+            const auto start = (size_t)(path.GetRectangle().GetY() / tileSize);
+            const auto length = (size_t)(path.GetRectangle().GetH() / tileSize);
+            const auto width = (size_t)(path.GetRectangle().GetX() / tileSize);
+
+            for (size_t i = 0; i < length; i++) {
+                tileMatrix[start + i][width] = Dungeon::Tile::PATH;
+            }
+        } else {
+            const auto start = (size_t)(path.GetRectangle().GetX() / tileSize);
+            const auto length = (size_t)(path.GetRectangle().GetW() / tileSize);
+            const auto height = (size_t)(path.GetRectangle().GetY() / tileSize);
+
+            for (size_t i = 0; i < length; i++) {
+                tileMatrix[height][start + i] = Dungeon::Tile::PATH;
+            }
+        }
+    }
+
+    for (const auto& room : dungeon.GetRooms()) {
+        const auto offsetX = (size_t)(room.GetRectangle().GetX() / tileSize);
+        const auto offsetY = (size_t)(room.GetRectangle().GetY() / tileSize);
+        const auto width = (size_t)(room.GetRectangle().GetW() / tileSize);
+        const auto height = (size_t)(room.GetRectangle().GetH() / tileSize);
+
+        for (size_t i = 0; i < height; i++) {
+            for (size_t j = 0; j < width; j++) {
+                tileMatrix[offsetY + i][offsetX + j] = Dungeon::Tile::ROOM;
+            }
+        }
+    }
+}
+
+Report BenchmarkRasterizer() {
+    const auto threads = (size_t)max(thread::hardware_concurrency(), 1u);
+
+    const pair<size_t, Point<float>> configurations[] = {
+        { 4, { 640.f, 480.f } },
+        { 8, { 2560.f, 1920.f } },
+        { 12, { 10240.f, 7680.f } },
+        { 14, { 20480.f, 15360.f } },
+        { 16, { 40960.f, 30720.f } }
+    };
+
+    Report report(
+        "rasterizer",
+        to_string(threads) + " thread(s), million tiles per second",
+        { "tiles", "reference", "serial", "threaded", "packed" }
+    );
+
+    for (const auto& configuration : configurations) {
+        const Dungeon dungeon(configuration.first, configuration.second, 10.f, { 0.45f, 0.45f }, 1);
+        const auto tiles = (double)(dungeon.GetTileMatrixWidth() * dungeon.GetTileMatrixHeight());
+
+        vector<vector<Dungeon::Tile>> tileMatrixReference {};
+        Matrix<Dungeon::Tile> tileMatrix {};
+        MatrixPacked<2> tileMatrixPacked {};
+
+        const auto secondsReference = Measure([&]() { RasterizeReference(dungeon, tileMatrixReference); });
+        const auto secondsSerial = Measure([&]() { dungeon.GenerateTileMatrix(tileMatrix); });
+        const auto secondsThreaded = Measure([&]() { dungeon.GenerateTileMatrix(tileMatrix, threads); });
+        const auto secondsPacked = Measure([&]() { dungeon.GenerateTileMatrix(tileMatrixPacked, threads); });
+
+        report.AddRow({
+            tiles,
+            tiles / secondsReference / 1e6,
+            tiles / secondsSerial / 1e6,
+            tiles / secondsThreaded / 1e6,
+            tiles / secondsPacked / 1e6
+        });
+    }
+
+    return report;
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "Engine/pch.h"
+
+#include "Engine/Utility/Profiler.h"
+
+#include "Game/Generation/Dungeon.h"
+
+#include "Benchmark.h"
+
+#if PROFILER_ENABLED
+// average milliseconds per frame of a zone
+static double GetZoneAverage(const char* name) {
+    Profiler::Statistics statistics {};
+    return profiler.GetStatistics(name, statistics) ? statistics.average : 0.;
+}
+#endif // PROFILER_ENABLED
+
+Report BenchmarkStages() {
+    const size_t iterations[] = { 4, 8, 12, 16 };
+    const Point<float> sizes[] = { { 640.f, 480.f }, { 2560.f, 1920.f }, { 10240.f, 7680.f } };
+
+    // the stages are timed by the profiler, without it there is nothing to put in their columns
+    Report report(
+        "stages",
+        "one thread, milliseconds and allocations per dungeon",
+        {
+            "iterations", "width", "height", "rooms", "paths",
+#if PROFILER_ENABLED
+            "split_ms", "rooms_ms", "paths_ms", "index_ms",
+#endif // PROFILER_ENABLED
+            "tiles_ms", "allocations", "allocated_kib", "tiles_allocations"
+        }
+    );
+
+#if !PROFILER_ENABLED
+    cerr << "the profiler is compiled out, the stages report has no split, rooms, paths or index columns\n";
+#endif // !PROFILER_ENABLED
+
+    for (const auto iteration : iterations) {
+        for (const auto& size : sizes) {
+            size_t runs = 0;
+            const auto allocations = GetAllocations();
+            const auto allocatedBytes = GetAllocatedBytes();
+
+            Measure([&]() {
+                const Dungeon dungeon(iteration, size, 10.f, { 0.45f, 0.45f }, runs);
+                runs++;
+            });
+
+            const auto allocationsPerRun = (double)(GetAllocations() - allocations) / (double)runs;
+            const auto allocatedPerRun = (double)(GetAllocatedBytes() - allocatedBytes) / (double)runs;
+
+#if PROFILER_ENABLED
+            // the stages are the profiler zones inside the constructor, every run is a frame of its own;
+            // recorded in a second pass so the profiler's buffers stay out of the allocations above
+            profiler.Clear();
+            profiler.SetRecording(true);
+
+            size_t seed = 0;
+            Measure([&]() {
+                const Dungeon dungeon(iteration, size, 10.f, { 0.45f, 0.45f }, seed++);
+                profiler.EndFrame();
+            });
+
+            profiler.SetRecording(false);
+#endif // PROFILER_ENABLED
+
+            // the tile matrix is reused between runs, as callers that regenerate it are expected to
+            const Dungeon dungeon(iteration, size, 10.f, { 0.45f, 0.45f }, 1);
+            Matrix<Dungeon::Tile> tileMatrix {};
+            dungeon.GenerateTileMatrix(tileMatrix);
+
+            size_t tilesRuns = 0;
+            const auto tilesAllocations = GetAllocations();
+            const auto secondsTiles = Measure([&]() {
+                dungeon.GenerateTileMatrix(tileMatrix);
+                tilesRuns++;
+            });
+
+            report.AddRow({
+                (double)iteration,
+                size.GetX(),
+                size.GetY(),
+                (double)dungeon.GetRooms().size(),
+                (double)dungeon.GetPaths().size(),
+#if PROFILER_ENABLED
+                GetZoneAverage("Dungeon::Split"),
+                GetZoneAverage("Dungeon::Rooms"),
+                GetZoneAverage("Dungeon::Paths"),
+                GetZoneAverage("Dungeon::BuildIndex"),
+#endif // PROFILER_ENABLED
+                secondsTiles * 1e3,
+                round(allocationsPerRun),
+                round(allocatedPerRun / 1024.),
+                round((double)(GetAllocations() - tilesAllocations) / (double)tilesRuns)
+            });
+        }
+    }
+
+    return report;
+}
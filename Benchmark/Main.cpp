@@ -0,0 +1,73 @@
+#include "Engine/pch.h"
+#include "Benchmark.h"
+
+static void PrintUsage() {
+    cout << "usage: Benchmark [rasterizer|encoding|stages|pathfinding|flowfield] [--format text|csv|json] [--output FILE]\n";
+}
+
+int main(int argc, char** argv) {
+    string filter {};
+    string output {};
+    auto format = Report::Format::TEXT;
+
+    for (int i = 1; i < argc; i++) {
+        const string argument = argv[i];
+
+        if (argument == "--format" && i + 1 < argc) {
+            const string value = argv[++i];
+
+            if (value == "text") {
+                format = Report::Format::TEXT;
+            } else if (value == "csv") {
+                format = Report::Format::CSV;
+            } else if (value == "json") {
+                format = Report::Format::JSON;
+            } else {
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (argument == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (argument[0] != '-' && filter.empty()) {
+            filter = argument;
+        } else {
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+    }
+
+    const pair<string, Report(*)()> benchmarks[] = {
+        { "rasterizer", BenchmarkRasterizer },
+        { "encoding", BenchmarkEncoding },
+        { "stages", BenchmarkStages },
+        { "pathfinding", BenchmarkPathfinding },
+        { "flowfield", BenchmarkFlowField }
+    };
+
+    vector<Report> reports {};
+    for (const auto& [name, benchmark] : benchmarks) {
+        if (filter.empty() || filter == name) {
+            reports.push_back(benchmark());
+        }
+    }
+
+    if (reports.empty()) {
+        PrintUsage();
+        return EXIT_FAILURE;
+    }
+
+    if (output.empty()) {
+        Report::Print(cout, reports, format);
+        return EXIT_SUCCESS;
+    }
+
+    ofstream stream(output);
+    Report::Print(stream, reports, format);
+
+    if (!stream) {
+        cout << "The file \"" << output << "\" could not be written!\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
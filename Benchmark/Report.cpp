@@ -0,0 +1,128 @@
+#include "Engine/pch.h"
+#include "Report.h"
+
+#include <iomanip>
+
+Report::Report(const string& name, const string& description, const vector<string>& columns)
+    : mName(name), mDescription(description), mColumns(columns) {}
+
+void Report::AddRow(const vector<double>& values) {
+    mRows.push_back(values);
+    mRows.back().resize(mColumns.size());
+}
+
+void Report::Print(ostream& stream, const Format format) const {
+    switch (format) {
+        case Format::TEXT:
+            PrintText(stream);
+            break;
+
+        case Format::CSV:
+            PrintCsv(stream);
+            break;
+
+        case Format::JSON:
+            PrintJson(stream);
+            break;
+    }
+}
+
+void Report::Print(ostream& stream, const vector<Report>& reports, const Format format) {
+    if (format == Format::JSON) {
+        stream << "[\n";
+    }
+
+    for (size_t i = 0; i < reports.size(); i++) {
+        if (i) {
+            stream << (format == Format::JSON ? ",\n" : "\n");
+        }
+
+        reports[i].Print(stream, format);
+    }
+
+    if (format == Format::JSON) {
+        stream << "\n]\n";
+    }
+}
+
+const string& Report::GetName() const {
+    return mName;
+}
+
+void Report::PrintText(ostream& stream) const {
+    // every column is as wide as its longest cell
+    vector<size_t> widths(mColumns.size());
+    for (size_t i = 0; i < mColumns.size(); i++) {
+        widths[i] = mColumns[i].size();
+
+        for (const auto& row : mRows) {
+            widths[i] = max(widths[i], ToString(row[i]).size());
+        }
+    }
+
+    const auto printCell = [&](const size_t column, const string& cell) {
+        // the last column is not padded, so lines carry no trailing spaces
+        stream << setw(column + 1 < widths.size() ? (int)widths[column] + 2 : 0) << cell;
+    };
+
+    stream << mName << ", " << mDescription << '\n' << left;
+    for (size_t i = 0; i < mColumns.size(); i++) {
+        printCell(i, mColumns[i]);
+    }
+    stream << '\n';
+
+    for (const auto& row : mRows) {
+        for (size_t i = 0; i < row.size(); i++) {
+            printCell(i, ToString(row[i]));
+        }
+        stream << '\n';
+    }
+}
+
+void Report::PrintCsv(ostream& stream) const {
+    stream << "benchmark";
+    for (const auto& column : mColumns) {
+        stream << ',' << column;
+    }
+    stream << '\n';
+
+    for (const auto& row : mRows) {
+        stream << mName;
+        for (const auto value : row) {
+            stream << ',' << ToString(value);
+        }
+        stream << '\n';
+    }
+}
+
+void Report::PrintJson(ostream& stream) const {
+    // names and descriptions are ours, so they never need escaping
+    stream << "  {\n"
+           << "    \"benchmark\": \"" << mName << "\",\n"
+           << "    \"description\": \"" << mDescription << "\",\n"
+           << "    \"rows\": [";
+
+    for (size_t i = 0; i < mRows.size(); i++) {
+        stream << (i ? ",\n" : "\n") << "      { ";
+
+        for (size_t j = 0; j < mColumns.size(); j++) {
+            stream << (j ? ", " : "") << '"' << mColumns[j] << "\": " << ToString(mRows[i][j]);
+        }
+
+        stream << " }";
+    }
+
+    stream << "\n    ]\n  }";
+}
+
+string Report::ToString(const double value) {
+    stringstream stream {};
+
+    if (value == floor(value) && fabs(value) < 1e15) {
+        stream << (int64_t)value;
+    } else {
+        stream << setprecision(6) << value;
+    }
+
+    return stream.str();
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// Rows of named columns a benchmark fills in, printed as an aligned table for people or as
+// CSV or JSON for scripts that compare runs to catch regressions
+class Report {
+public:
+    enum class Format : uint8_t {
+        TEXT,
+        CSV,
+        JSON
+    };
+
+    Report(const string& name, const string& description, const vector<string>& columns);
+
+    // one value per column
+    void AddRow(const vector<double>& values);
+
+    void Print(ostream& stream, const Format format) const;
+
+    // prints every report, JSON as one document holding all of them
+    static void Print(ostream& stream, const vector<Report>& reports, const Format format);
+
+    const string& GetName() const;
+
+private:
+    void PrintText(ostream& stream) const;
+
+    void PrintCsv(ostream& stream) const;
+
+    void PrintJson(ostream& stream) const;
+
+    // integers without an exponent, everything else with 6 significant digits
+    static string ToString(const double value);
+
+    string mName {};
+    string mDescription {};
+    vector<string> mColumns {};
+    vector<vector<double>> mRows {};
+};
\ No newline at end of file
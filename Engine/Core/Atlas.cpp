@@ -0,0 +1,260 @@
+#include "pch.h"
+#include "Utility/Miscellaneous.h"
+#include "Utility/PackerSkyline.h"
+#include "SDL_image.h"
+#include "Atlas.h"
+
+bool Atlas::Build(const vector<string>& images, const string& output, const int pageSize /* = 2048 */, const int padding /* = 1 */) {
+    LOG_AND_RETURN_IF(pageSize <= 0 || padding < 0, "The atlas page size or padding is invalid!", LOG_TYPE_ERROR, false);
+
+    struct Image {
+        string name {};
+        SDL_Surface* surface = nullptr;
+        uint32_t page {};
+        SDL_Rect rect {};
+    };
+
+    // names are the keys of the table and are written unquoted, so they must be unique and
+    // free of whitespace, the page files too
+    const auto isName = [](const string& name) {
+        return !name.empty() && name.find_first_of(" \t\r\n") == string::npos;
+    };
+
+    LOG_AND_RETURN_IF(!isName(path(output).stem().string()), "The atlas name \"" + output + "\" is empty or contains whitespace!", LOG_TYPE_ERROR, false);
+
+    map<string, string> names {};
+    for (const auto& image : images) {
+        const auto name = path(image).stem().string();
+        LOG_AND_RETURN_IF(!isName(name), "The image name \"" + image + "\" is empty or contains whitespace!", LOG_TYPE_ERROR, false);
+
+        const auto [iterator, isInserted] = names.emplace(name, image);
+        LOG_AND_RETURN_IF(!isInserted, "The images \"" + iterator->second + "\" and \"" + image + "\" would both be named \"" + name + "\"!", LOG_TYPE_ERROR, false);
+    }
+
+    vector<Image> sources {};
+    const auto freeSources = [&]() {
+        for (const auto& source : sources) {
+            SDL_FreeSurface(source.surface);
+        }
+    };
+
+    for (const auto& image : images) {
+        const auto surface = IMG_Load(image.c_str());
+        if (!surface) {
+            LOG("The image \"" + image + "\" could not be loaded! Error: " + IMG_GetError() + '.', LOG_TYPE_ERROR);
+            freeSources();
+            return false;
+        }
+
+        sources.push_back({ path(image).stem().string(), surface });
+
+        if (surface->w + 2 * padding > pageSize || surface->h + 2 * padding > pageSize) {
+            LOG("The image \"" + image + "\" does not fit in a page!", LOG_TYPE_ERROR);
+            freeSources();
+            return false;
+        }
+    }
+
+    // the tallest go first, so every row of the skyline starts with the ones that shape it
+    vector<size_t> order(sources.size());
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+
+    sort(order.begin(), order.end(), [&](const size_t left, const size_t right) {
+        const auto& surfaceLeft = *sources[left].surface;
+        const auto& surfaceRight = *sources[right].surface;
+
+        return surfaceLeft.h != surfaceRight.h ? surfaceLeft.h > surfaceRight.h : surfaceLeft.w > surfaceRight.w;
+    });
+
+    // every page is tried before opening a new one, the small images fill the gaps of the first
+    vector<PackerSkyline> packers {};
+    for (const auto i : order) {
+        auto& source = sources[i];
+
+        // the padding on the right and bottom of every image, the page adds it on the left and top
+        const auto w = (uint32_t)(source.surface->w + padding), h = (uint32_t)(source.surface->h + padding);
+
+        uint32_t x {}, y {};
+        size_t page = 0;
+        while (page < packers.size() && !packers[page].Insert(w, h, x, y)) {
+            page++;
+        }
+
+        if (page == packers.size()) {
+            packers.emplace_back((uint32_t)(pageSize - padding), (uint32_t)(pageSize - padding));
+            packers.back().Insert(w, h, x, y);
+        }
+
+        source.page = (uint32_t)page;
+        source.rect = { (int)x + padding, (int)y + padding, source.surface->w, source.surface->h };
+    }
+
+    const auto directory = path(output).parent_path();
+    const auto stem = path(output).stem().string();
+
+    ofstream table(output);
+    if (!table) {
+        LOG("The atlas table \"" + output + "\" could not be written!", LOG_TYPE_ERROR);
+        freeSources();
+        return false;
+    }
+
+    table << "atlas " << mVersion << ' ' << packers.size() << '\n';
+
+    // pages are cut down to what they hold, a lone tile should not cost a whole page
+    for (size_t page = 0; page < packers.size(); page++) {
+        const auto w = (int)packers[page].GetUsedWidth() + padding;
+        const auto h = (int)packers[page].GetUsedHeight() + padding;
+
+        const auto surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_RGBA32);
+        if (!surface) {
+            LOG("The atlas page could not be created! Error: " + string(SDL_GetError()) + '.', LOG_TYPE_ERROR);
+            freeSources();
+            return false;
+        }
+
+        for (auto& source : sources) {
+            if (source.page == page) {
+                // copied as they are, blending into the transparent page would darken the edges
+                SDL_SetSurfaceBlendMode(source.surface, SDL_BLENDMODE_NONE);
+                SDL_BlitSurface(source.surface, nullptr, surface, &source.rect);
+            }
+        }
+
+        const auto file = stem + to_string(page) + ".png";
+        const auto saved = !IMG_SavePNG(surface, (directory / file).string().c_str());
+        SDL_FreeSurface(surface);
+
+        if (!saved) {
+            LOG("The atlas page \"" + file + "\" could not be saved! Error: " + IMG_GetError() + '.', LOG_TYPE_ERROR);
+            freeSources();
+            return false;
+        }
+
+        table << "page " << file << ' ' << w << ' ' << h << '\n';
+    }
+
+    for (const auto& source : sources) {
+        table << "region " << source.name << ' ' << source.page << ' '
+              << source.rect.x << ' ' << source.rect.y << ' ' << source.rect.w << ' ' << source.rect.h << '\n';
+    }
+
+    freeSources();
+
+    LOG_AND_RETURN_IF(!table, "The atlas table \"" + output + "\" could not be written!", LOG_TYPE_ERROR, false);
+    return true;
+}
+
+bool Atlas::IsPage(const string& image, const string& output) {
+    const path pathImage(image), pathOutput(output);
+    if (pathImage.extension() != ".png" ||
+        absolute(pathImage).parent_path().lexically_normal() != absolute(pathOutput).parent_path().lexically_normal()) {
+        return false;
+    }
+
+    const auto stemImage = pathImage.stem().string();
+    const auto stemOutput = pathOutput.stem().string();
+    if (stemImage.size() <= stemOutput.size() || stemImage.compare(0, stemOutput.size(), stemOutput)) {
+        return false;
+    }
+
+    return all_of(stemImage.begin() + stemOutput.size(), stemImage.end(), [](const char c) { return isdigit((unsigned char)c); });
+}
+
+bool Atlas::Open(const string& table) {
+    Clear();
+
+    ifstream stream(table);
+    LOG_AND_RETURN_IF(!stream, "The atlas table \"" + table + "\" could not be read!", LOG_TYPE_WARNING, false);
+
+    const auto fail = [&](const string& reason) {
+        LOG("The atlas table \"" + table + "\" " + reason, LOG_TYPE_WARNING);
+        Clear();
+        return false;
+    };
+
+    // every line is read on its own and must hold exactly its fields, so a stray or missing
+    // field is caught on its line instead of shifting every field after it
+    string line {};
+    string kind {};
+    uint32_t version {};
+    size_t pages {};
+
+    getline(stream, line);
+    stringstream header(line);
+    header >> kind >> version >> pages;
+    if (!header || kind != "atlas" || version != mVersion || !(header >> ws).eof()) {
+        return fail("is not supported!");
+    }
+
+    const auto directory = path(table).parent_path();
+    vector<SDL_Point> pageSizes {};
+
+    while (getline(stream, line)) {
+        stringstream fields(line);
+        if (!(fields >> kind)) {
+            continue;
+        }
+
+        auto isValid = false;
+
+        if (kind == "page") {
+            string file {};
+            SDL_Point size {};
+            fields >> file >> size.x >> size.y;
+            isValid = fields && size.x > 0 && size.y > 0;
+
+            mPages.push_back((directory / file).string());
+            pageSizes.push_back(size);
+        } else if (kind == "region") {
+            string name {};
+            Region region {};
+            fields >> name >> region.page >> region.rect.x >> region.rect.y >> region.rect.w >> region.rect.h;
+
+            // pages come before the regions, so the one a region points into is known by now
+            const auto& rect = region.rect;
+            isValid = fields && region.page < pageSizes.size() &&
+                rect.x >= 0 && rect.y >= 0 && rect.w > 0 && rect.h > 0 &&
+                rect.x + rect.w <= pageSizes[region.page].x && rect.y + rect.h <= pageSizes[region.page].y;
+
+            if (isValid && !mRegions.emplace(name, region).second) {
+                return fail("names the region \"" + name + "\" twice!");
+            }
+        }
+
+        if (!isValid || !(fields >> ws).eof()) {
+            return fail("is corrupted!");
+        }
+    }
+
+    if (mPages.size() != pages) {
+        return fail("is missing pages!");
+    }
+
+    return true;
+}
+
+void Atlas::Clear() {
+    mPages.clear();
+    mRegions.clear();
+}
+
+const vector<string>& Atlas::GetPages() const {
+    return mPages;
+}
+
+const map<string, Atlas::Region, less<>>& Atlas::GetRegions() const {
+    return mRegions;
+}
+
+bool Atlas::GetRegion(const string_view name, Region& region) const {
+    const auto iterator = mRegions.find(name);
+    if (iterator == mRegions.end()) {
+        return false;
+    }
+
+    region = iterator->second;
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "SDL.h"
+
+// A baked atlas is a few PNG pages and a text table next to them:
+//     atlas <version> <pages>
+//     page <file> <w> <h>
+//     region <name> <page> <x> <y> <w> <h>
+// Page files are relative to the table, names are the image files without their extension,
+// which makes them unique and free of whitespace. Every region lies inside its page.
+class Atlas {
+public:
+    struct Region {
+        uint32_t page {};
+        SDL_Rect rect {};
+    };
+
+    static constexpr uint32_t mVersion = 2;
+
+    // Packs the images into as few pages of pageSize as it can, with padding pixels between them,
+    // and writes the table to output and the pages beside it
+    static bool Build(const vector<string>& images, const string& output, const int pageSize = 2048, const int padding = 1);
+
+    // whether image is one of the pages Build writes for output, i.e. <stem><N>.png beside it,
+    // so baking a directory into itself does not pack the previous pages back in
+    static bool IsPage(const string& image, const string& output);
+
+    bool Open(const string& table);
+
+    void Clear();
+
+    // paths of the pages, ready to be loaded
+    const vector<string>& GetPages() const;
+
+    const map<string, Region, less<>>& GetRegions() const;
+
+    bool GetRegion(const string_view name, Region& region) const;
+
+private:
+    vector<string> mPages {};
+    map<string, Region, less<>> mRegions {};
+};
\ No newline at end of file
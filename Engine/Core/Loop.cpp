@@ -0,0 +1,109 @@
+#include "pch.h"
+#include "Loop.h"
+
+Loop::Loop(const double timestep /* = 1. / 60. */, const size_t updatesMax /* = 5 */, const int32_t idleTimeout /* = 100 */)
+    : mTimestep(timestep),
+    mUpdatesMax(max<size_t>(updatesMax, 1)),
+    mIdleTimeout(idleTimeout) {}
+
+void Loop::BeginFrame() {
+    if (!mIsDirty && !mHasEvent) {
+        Stopwatch stopwatch {};
+        mHasEvent = SDL_WaitEventTimeout(&mEvent, mIdleTimeout) == 1;
+
+        mStatistics.waits++;
+        mStatistics.idle += stopwatch.GetSeconds();
+
+        // nothing was simulated while the scene sat still, so the wait is not owed any steps
+        mStopwatchStep.Restart();
+    }
+
+    mStopwatchFrame.Restart();
+    mStatistics.frames++;
+
+    mAccumulator += mStopwatchStep.GetSeconds();
+    mStopwatchStep.Restart();
+    mUpdates = 0;
+}
+
+bool Loop::PollEvent(SDL_Event& event) {
+    if (mHasEvent) {
+        event = mEvent;
+        mHasEvent = false;
+
+        return true;
+    }
+
+    return SDL_PollEvent(&event) == 1;
+}
+
+bool Loop::Update() {
+    if (mAccumulator < mTimestep) {
+        return false;
+    }
+
+    // a frame that took too long would only fall further behind catching up
+    if (mUpdates == mUpdatesMax) {
+        mAccumulator = 0.;
+        return false;
+    }
+
+    mAccumulator -= mTimestep;
+    mUpdates++;
+    mStatistics.updates++;
+
+    return true;
+}
+
+double Loop::GetAlpha() const {
+    return mAccumulator / mTimestep;
+}
+
+double Loop::GetTimestep() const {
+    return mTimestep;
+}
+
+void Loop::Invalidate() {
+    mIsDirty = true;
+}
+
+bool Loop::IsDirty() const {
+    return mIsDirty;
+}
+
+bool Loop::ShouldRender() {
+    mIsRendering = mIsDirty;
+    mIsDirty = false;
+
+    return mIsRendering;
+}
+
+void Loop::EndFrame() {
+    mStatistics.busy += mStopwatchFrame.GetSeconds();
+
+    if (!mIsRendering) {
+        return;
+    }
+    mIsRendering = false;
+
+    if (mHasRendered) {
+        const auto interval = mStopwatchRender.GetSeconds() * 1000.;
+        const auto intervals = (double)mStatistics.rendered;
+
+        mStatistics.renderIntervalAverage += (interval - mStatistics.renderIntervalAverage) / intervals;
+        mStatistics.renderIntervalMax = max(mStatistics.renderIntervalMax, interval);
+    }
+
+    mStopwatchRender.Restart();
+    mHasRendered = true;
+    mStatistics.rendered++;
+}
+
+const Loop::Statistics& Loop::GetStatistics() const {
+    return mStatistics;
+}
+
+void Loop::ResetStatistics() {
+    mStatistics = {};
+    mHasRendered = false;
+}
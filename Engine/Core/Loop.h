@@ -0,0 +1,75 @@
+#pragma once
+
+#include "SDL.h"
+
+#include "Engine/Utility/Stopwatch.h"
+
+// Runs the simulation in fixed steps and draws only when something changed.
+// A frame goes BeginFrame, PollEvent until it is false, Update until it is false and, when
+// ShouldRender says so, the drawing, then EndFrame. While nothing is dirty BeginFrame sleeps
+// on the event queue, so an idle window costs neither a core nor the GPU.
+class Loop {
+public:
+    struct Statistics {
+        size_t frames {};
+        size_t rendered {};
+        size_t updates {};
+        size_t waits {};
+
+        // in seconds, the time blocked on the event queue against the time spent in frames
+        double idle {};
+        double busy {};
+
+        // in milliseconds, between rendered frames
+        double renderIntervalAverage {};
+        double renderIntervalMax {};
+    };
+
+    Loop(const double timestep = 1. / 60., const size_t updatesMax = 5, const int32_t idleTimeout = 100);
+
+    // waits for an event while the scene is clean and adds the time since the last frame to the steps
+    void BeginFrame();
+
+    // hands out the event that ended the wait first
+    bool PollEvent(SDL_Event& event);
+
+    // true while a fixed step is due, a frame runs at most updatesMax of them and drops the rest
+    bool Update();
+
+    // how far the frame is into the next step, for interpolating between the last two
+    double GetAlpha() const;
+    double GetTimestep() const;
+
+    // the next frame is drawn, even when asked while this one is drawing
+    void Invalidate();
+    bool IsDirty() const;
+
+    // whether this frame is drawn, it takes the dirty state
+    bool ShouldRender();
+
+    void EndFrame();
+
+    const Statistics& GetStatistics() const;
+    void ResetStatistics();
+
+private:
+    const double mTimestep {};
+    const size_t mUpdatesMax {};
+    const int32_t mIdleTimeout {};
+
+    double mAccumulator {};
+    size_t mUpdates {};
+
+    bool mIsDirty = true;
+    bool mIsRendering = false;
+
+    SDL_Event mEvent {};
+    bool mHasEvent = false;
+
+    Stopwatch mStopwatchStep {};
+    Stopwatch mStopwatchFrame {};
+    Stopwatch mStopwatchRender {};
+    bool mHasRendered = false;
+
+    Statistics mStatistics {};
+};
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "pch.h"
 #include "Utility/Miscellaneous.h"
 #include "Utility/ManagerFile.h"
+#include "Utility/Profiler.h"
+#include "Utility/Stopwatch.h"
+#include "Atlas.h"
 #include "ManagerTexture.h"
 
 ManagerTexture::ManagerTexture() {
@@ -16,9 +19,20 @@ ManagerTexture::ManagerTexture() {
 }
 
 ManagerTexture::~ManagerTexture() {
-    for (const auto& item : mTextures) {
-        if (item.second) {
-            SDL_DestroyTexture(item.second);
+    // the workers finish what they started before their images can be freed
+    mThreadPool.reset();
+
+    for (const auto& [handle, surface] : mDecoded) {
+        SDL_FreeSurface(surface);
+    }
+
+    for (const auto& [handle, surface] : mUploads) {
+        SDL_FreeSurface(surface);
+    }
+
+    for (const auto& slot : mSlots) {
+        if (slot.texture) {
+            SDL_DestroyTexture(slot.texture);
         }
     }
 
@@ -47,58 +61,303 @@ void ManagerTexture::Render(SDL_Renderer* renderer, SDL_Texture* texture, const
     }
 }
 
-SDL_Texture* ManagerTexture::Load(SDL_Renderer* renderer, const string& path) {
-    LOG_AND_RETURN_IF_NOT_INIT(mIsInitialized, mSubsystems, nullptr);
-    LOG_AND_RETURN_IF_PARAM_IS_NULL(renderer, nullptr);
-    if (!ManagerFile::Exists(path)) {
-        LOG("The texture's path \"" + path + "\" is invalid!", LOG_TYPE_WARNING);
-        return nullptr;
+void ManagerTexture::Render(SDL_Renderer* renderer, const Handle handle, const SDL_Point& position, const SDL_FPoint& size, const SDL_Rect& textureRect) const {
+    LOG_AND_RETURN_IF_NOT_INIT(mIsInitialized, mSubsystems, );
+    LOG_AND_RETURN_IF_PARAM_IS_NULL(renderer, );
+
+    const auto texture = GetTexture(handle);
+    LOG_AND_RETURN_IF_PARAM_IS_NULL(texture, );
+
+    const auto isWhole = textureRect.x == -1 && textureRect.y == -1 &&
+                         textureRect.w == -1 && textureRect.h == -1;
+
+    const auto sizeSource = isWhole ? mSlots[handle & mIndexMask].size : SDL_Point { textureRect.w, textureRect.h };
+    const SDL_Rect textureRectFinal = { position.x, position.y, (int)(sizeSource.x * size.x), (int)(sizeSource.y * size.y) };
+
+    SDL_RenderCopy(renderer, texture, isWhole ? nullptr : &textureRect, &textureRectFinal);
+}
+
+void ManagerTexture::Render(SDL_Renderer* renderer, const Region& region, const SDL_Point& position, const SDL_FPoint& size) const {
+    if (SDL_RectEmpty(&region.rect)) {
+        Render(renderer, region.texture, position, size);
+    } else {
+        Render(renderer, region.texture, position, size, region.rect);
     }
+}
 
-    if (mTextures.find(path) != mTextures.end()) {
-        return mTextures[path];
+ManagerTexture::Handle ManagerTexture::Load(SDL_Renderer* renderer, const string_view path) {
+    LOG_AND_RETURN_IF_NOT_INIT(mIsInitialized, mSubsystems, mHandleInvalid);
+    LOG_AND_RETURN_IF_PARAM_IS_NULL(renderer, mHandleInvalid);
+
+    const auto iterator = mHandles.find(path);
+    if (iterator != mHandles.end()) {
+        return iterator->second;
     }
 
-    SDL_Texture* newTexture = nullptr;
+    // only a path never loaded before reaches the file system
+    const string pathString(path);
+    if (!ManagerFile::Exists(pathString)) {
+        LOG("The texture's path \"" + pathString + "\" is invalid!", LOG_TYPE_WARNING);
+        return mHandleInvalid;
+    }
 
-    SDL_Surface* surface = IMG_Load(path.c_str());
+    SDL_Surface* surface = IMG_Load(pathString.c_str());
     if (!surface) {
-        LOG("The surface for the texture \"" + path + "\" could not be loaded! Error: " + IMG_GetError() + '.', LOG_TYPE_WARNING);
-    } else {
-        newTexture = SDL_CreateTextureFromSurface(renderer, surface);
-        if (!newTexture) {
-            LOG("The texture \"" + path + "\" could not be created! Error: " + IMG_GetError() + '.', LOG_TYPE_WARNING);
-        } else {
-            mTextures[path] = newTexture;
+        LOG("The surface for the texture \"" + pathString + "\" could not be loaded! Error: " + IMG_GetError() + '.', LOG_TYPE_WARNING);
+        return mHandleInvalid;
+    }
+
+    const auto texture = SDL_CreateTextureFromSurface(renderer, surface);
+    const SDL_Point size = { surface->w, surface->h };
+    SDL_FreeSurface(surface);
+
+    if (!texture) {
+        LOG("The texture \"" + pathString + "\" could not be created! Error: " + IMG_GetError() + '.', LOG_TYPE_WARNING);
+        return mHandleInvalid;
+    }
+
+    return AddSlot(pathString, texture, size);
+}
+
+ManagerTexture::Handle ManagerTexture::LoadAsync(const string_view path) {
+    LOG_AND_RETURN_IF_NOT_INIT(mIsInitialized, mSubsystems, mHandleInvalid);
+
+    const auto iterator = mHandles.find(path);
+    if (iterator != mHandles.end()) {
+        return iterator->second;
+    }
+
+    const string pathString(path);
+    if (!ManagerFile::Exists(pathString)) {
+        LOG("The texture's path \"" + pathString + "\" is invalid!", LOG_TYPE_WARNING);
+        return mHandleInvalid;
+    }
+
+    const auto handle = AddSlot(pathString, nullptr, {});
+    if (handle == mHandleInvalid) {
+        return mHandleInvalid;
+    }
+
+    mSlots[handle & mIndexMask].isPending = true;
+    mPending++;
+    mDecoding++;
+
+    if (!mThreadPool) {
+        // one thread is left for the renderer and one for whatever generates the level meanwhile
+        mThreadPool = make_unique<ThreadPool>(max(thread::hardware_concurrency(), 3u) - 2);
+    }
+
+    // SDL_CreateTextureFromSurface must run on the render thread, IMG_Load does not
+    mThreadPool->Submit([this, handle, pathString]() {
+        const auto surface = IMG_Load(pathString.c_str());
+
+        lock_guard lock(mDecodedMutex);
+        mDecoded.push_back({ handle, surface });
+    });
+
+    return handle;
+}
+
+bool ManagerTexture::Preload(const string_view manifest, vector<Handle>& handles) {
+    const string manifestString(manifest);
+
+    ifstream stream(manifestString);
+    if (!stream) {
+        LOG("The manifest \"" + manifestString + "\" could not be read!", LOG_TYPE_WARNING);
+        return false;
+    }
+
+    string line {};
+    while (getline(stream, line)) {
+        const auto first = line.find_first_not_of(" \t\r");
+        if (first == string::npos || line[first] == '#') {
+            continue;
         }
 
+        const auto last = line.find_last_not_of(" \t\r");
+        handles.push_back(LoadAsync(string_view(line).substr(first, last - first + 1)));
+    }
+
+    return true;
+}
+
+size_t ManagerTexture::Upload(SDL_Renderer* renderer, const double budget) {
+    PROFILE_SCOPE("ManagerTexture::Upload");
+
+    LOG_AND_RETURN_IF_NOT_INIT(mIsInitialized, mSubsystems, 0);
+    LOG_AND_RETURN_IF_PARAM_IS_NULL(renderer, 0);
+
+    // not mPending, surfaces of images removed while decoding still have to be freed here
+    if (!mDecoding && mUploads.empty()) {
+        return 0;
+    }
+
+    {
+        lock_guard lock(mDecodedMutex);
+        mUploads.insert(mUploads.end(), mDecoded.begin(), mDecoded.end());
+        mDecoding -= mDecoded.size();
+        mDecoded.clear();
+    }
+
+    Stopwatch stopwatch {};
+
+    size_t uploaded = 0;
+    size_t i = 0;
+    for (; i < mUploads.size() && (!i || stopwatch.GetSeconds() < budget); i++) {
+        const auto [handle, surface] = mUploads[i];
+        auto& slot = mSlots[handle & mIndexMask];
+
+        // removed while it was being decoded, its slot may even belong to another image by now
+        if (slot.handle != handle) {
+            SDL_FreeSurface(surface);
+            continue;
+        }
+
+        slot.isPending = false;
+        mPending--;
+
+        if (!surface) {
+            // SDL keeps errors per thread, the one of the worker is gone by now
+            LOG("The surface for the texture \"" + slot.path->first + "\" could not be loaded!", LOG_TYPE_WARNING);
+            RemoveSlot(handle);
+            continue;
+        }
+
+        slot.texture = SDL_CreateTextureFromSurface(renderer, surface);
+        slot.size = { surface->w, surface->h };
         SDL_FreeSurface(surface);
+
+        if (!slot.texture) {
+            LOG("The texture \"" + slot.path->first + "\" could not be created! Error: " + IMG_GetError() + '.', LOG_TYPE_WARNING);
+            RemoveSlot(handle);
+            continue;
+        }
+
+        uploaded++;
+    }
+
+    mUploads.erase(mUploads.begin(), mUploads.begin() + i);
+    return uploaded;
+}
+
+bool ManagerTexture::LoadAtlas(const string_view table) {
+    LOG_AND_RETURN_IF_NOT_INIT(mIsInitialized, mSubsystems, false);
+
+    Atlas atlas {};
+    if (!atlas.Open(string(table))) {
+        return false;
+    }
+
+    vector<Handle> pages {};
+    for (const auto& page : atlas.GetPages()) {
+        pages.push_back(LoadAsync(page));
+    }
+
+    for (const auto& [name, region] : atlas.GetRegions()) {
+        mRegions[name] = { pages[region.page], region.rect };
+    }
+
+    return true;
+}
+
+bool ManagerTexture::GetRegion(const string_view name, Region& region) const {
+    const auto iterator = mRegions.find(name);
+    if (iterator == mRegions.end()) {
+        return false;
     }
 
-    return newTexture;
+    region = iterator->second;
+    return true;
 }
 
-void ManagerTexture::Remove(SDL_Texture* texture) {
+SDL_FRect ManagerTexture::GetCoordinates(const Region& region) const {
+    const auto size = GetSize(region.texture);
+    if (SDL_RectEmpty(&region.rect) || !size.x || !size.y) {
+        return { 0.f, 0.f, 1.f, 1.f };
+    }
+
+    return { (float)region.rect.x / (float)size.x, (float)region.rect.y / (float)size.y,
+             (float)region.rect.w / (float)size.x, (float)region.rect.h / (float)size.y };
+}
+
+bool ManagerTexture::IsPending(const Handle handle) const {
+    const auto index = handle & mIndexMask;
+    return index < mSlots.size() && mSlots[index].handle == handle && mSlots[index].isPending;
+}
+
+size_t ManagerTexture::GetPending() const {
+    return mPending;
+}
+
+void ManagerTexture::Remove(const Handle handle) {
     LOG_AND_RETURN_IF_NOT_INIT(mIsInitialized, mSubsystems, );
-    LOG_AND_RETURN_IF_PARAM_IS_NULL(texture, );
 
-    for (const auto& item : mTextures) {
-        if (texture == item.second) {
-            mTextures.erase(item.first);
-            break;
-        }
+    // a pending image is dropped by Upload once it is decoded
+    if (IsPending(handle)) {
+        mPending--;
+        RemoveSlot(handle);
+        return;
     }
 
+    const auto texture = GetTexture(handle);
+    LOG_AND_RETURN_IF_PARAM_IS_NULL(texture, );
+
+    RemoveSlot(handle);
     SDL_DestroyTexture(texture);
 }
 
-SDL_Texture* ManagerTexture::GetTexture(const string& path) {
-    LOG_AND_RETURN_IF_NOT_INIT(mIsInitialized, mSubsystems, nullptr);
+ManagerTexture::Handle ManagerTexture::GetHandle(const string_view path) const {
+    const auto iterator = mHandles.find(path);
+    return iterator != mHandles.end() ? iterator->second : mHandleInvalid;
+}
+
+SDL_Point ManagerTexture::GetSize(const Handle handle) const {
+    return GetTexture(handle) ? mSlots[handle & mIndexMask].size : SDL_Point {};
+}
+
+size_t ManagerTexture::GetCount() const {
+    return mHandles.size();
+}
 
-    if (!ManagerFile::Exists(path)) {
-        LOG("The texture's path \"" + path + "\" is invalid!", LOG_TYPE_WARNING);
-        return nullptr;
+ManagerTexture::Handle ManagerTexture::AddSlot(const string& path, SDL_Texture* texture, const SDL_Point& size) {
+    uint32_t index {};
+    if (!mSlotsFree.empty()) {
+        index = mSlotsFree.back();
+        mSlotsFree.pop_back();
+    } else {
+        if (mSlots.size() > mIndexMask) {
+            LOG("There is no handle left for the texture \"" + path + "\"!", LOG_TYPE_ERROR);
+
+            if (texture) {
+                SDL_DestroyTexture(texture);
+            }
+            return mHandleInvalid;
+        }
+
+        index = (uint32_t)mSlots.size();
+        mSlots.emplace_back();
     }
 
-    return (mTextures.find(path) != mTextures.end()) ? mTextures[path] : nullptr;
+    // the generation wraps around within its bits and skips 0, which would make handle 0 valid
+    auto& slot = mSlots[index];
+    slot.generation = (slot.generation + 1) & (UINT32_MAX >> mIndexBits);
+    slot.generation += !slot.generation;
+
+    slot.texture = texture;
+    slot.size = size;
+    slot.handle = (slot.generation << mIndexBits) | index;
+    slot.path = mHandles.emplace(path, slot.handle).first;
+    slot.isPending = false;
+
+    return slot.handle;
+}
+
+void ManagerTexture::RemoveSlot(const Handle handle) {
+    auto& slot = mSlots[handle & mIndexMask];
+    mHandles.erase(slot.path);
+
+    slot.texture = nullptr;
+    slot.handle = mHandleInvalid;
+    slot.isPending = false;
+    mSlotsFree.push_back(handle & mIndexMask);
 }
@@ -1,26 +1,129 @@
 #pragma once
 
+#include "SDL.h"
+#include "SDL_image.h"
+
+#include "Engine/Utility/ThreadPool.h"
+
+#include <memory>
+
 #define IMG_INIT_EVERYTHING (IMG_INIT_JPG | IMG_INIT_PNG | IMG_INIT_TIF | IMG_INIT_WEBP)
 
+// Textures are looked up by path once, when they are loaded, and by handle afterwards.
+// A handle indexes straight into an array and carries the generation of its slot, so a handle
+// kept after Remove never reaches the texture loaded into the slot later.
+// Images may also be decoded on worker threads: their handles are valid at once, but their
+// textures only exist after an Upload on the render thread picked them up.
 class ManagerTexture {
 public:
+    using Handle = uint32_t;
+
+    static constexpr Handle mHandleInvalid = 0;
+
+    // part of a texture, the whole of it when rect is empty
+    struct Region {
+        Handle texture = mHandleInvalid;
+        SDL_Rect rect {};
+    };
+
     ManagerTexture();
 
     ~ManagerTexture();
 
+    ManagerTexture(const ManagerTexture&) = delete;
+
+    ManagerTexture& operator=(const ManagerTexture&) = delete;
+
     static void Render(SDL_Renderer* renderer, SDL_Texture* texture, const SDL_Point& position, const SDL_FPoint& size = { 1.f, 1.f }, const SDL_Rect& textureRect = { -1, -1, -1, -1 });
 
-    SDL_Texture* Load(SDL_Renderer* renderer, const string& path);
+    // same as above without querying the texture for its size, the size scales textureRect when given
+    void Render(SDL_Renderer* renderer, const Handle handle, const SDL_Point& position, const SDL_FPoint& size = { 1.f, 1.f }, const SDL_Rect& textureRect = { -1, -1, -1, -1 }) const;
+
+    void Render(SDL_Renderer* renderer, const Region& region, const SDL_Point& position, const SDL_FPoint& size = { 1.f, 1.f }) const;
+
+    // Loads the texture from path unless it was loaded before, in which case the existing
+    // handle comes back without touching the file system, mHandleInvalid when loading fails
+    Handle Load(SDL_Renderer* renderer, const string_view path);
+
+    // Decodes the image on a worker thread, the texture is created by a later Upload
+    Handle LoadAsync(const string_view path);
+
+    // LoadAsync for every line of manifest, blank lines and lines starting with # aside
+    bool Preload(const string_view manifest, vector<Handle>& handles);
+
+    // Creates the textures of the images decoded so far, stopping once budget seconds passed.
+    // At least one is created per call, so a tiny budget still makes progress.
+    size_t Upload(SDL_Renderer* renderer, const double budget);
+
+    // Queues the pages of a table baked by Atlas::Build and names its regions, which resolve
+    // at once while the pages stream in like any LoadAsync
+    bool LoadAtlas(const string_view table);
+
+    bool GetRegion(const string_view name, Region& region) const;
 
-    void Remove(SDL_Texture* texture);
+    // the region in texture coordinates, all of the texture until its size is known
+    SDL_FRect GetCoordinates(const Region& region) const;
 
-    SDL_Texture* GetTexture(const string& path);
+    bool IsPending(const Handle handle) const;
+
+    // images queued by LoadAsync whose textures were not created yet
+    size_t GetPending() const;
+
+    void Remove(const Handle handle);
+
+    // the handle of the texture already loaded from path, if any
+    Handle GetHandle(const string_view path) const;
+
+    SDL_Texture* GetTexture(const Handle handle) const {
+        const auto index = handle & mIndexMask;
+        return index < mSlots.size() && mSlots[index].handle == handle ? mSlots[index].texture : nullptr;
+    }
+
+    SDL_Point GetSize(const Handle handle) const;
+
+    size_t GetCount() const;
 
 private:
+    static constexpr uint32_t mIndexBits = 20;
+    static constexpr uint32_t mIndexMask = (1u << mIndexBits) - 1;
+
+    // less<> lets string_views find paths without building a string
+    using Handles = map<string, Handle, less<>>;
+
+    struct Slot {
+        SDL_Texture* texture = nullptr;
+        SDL_Point size {};
+        // 0 once removed, generation and index otherwise
+        Handle handle = mHandleInvalid;
+        uint32_t generation {};
+        Handles::iterator path {};
+        bool isPending {};
+    };
+
+    Handle AddSlot(const string& path, SDL_Texture* texture, const SDL_Point& size);
+
+    void RemoveSlot(const Handle handle);
+
     static inline bool mIsInitialized = false;
     static inline uint32_t mObjectCounter = 0;
 
-    map<string, SDL_Texture*> mTextures;
+    vector<Slot> mSlots {};
+    vector<uint32_t> mSlotsFree {};
+
+    Handles mHandles {};
+    map<string, Region, less<>> mRegions {};
+
+    // the workers hand decoded images over through mDecoded, the render thread moves them to
+    // mUploads so the lock is held only for a swap
+    unique_ptr<ThreadPool> mThreadPool {};
+    mutex mDecodedMutex {};
+    vector<pair<Handle, SDL_Surface*>> mDecoded {};
+    vector<pair<Handle, SDL_Surface*>> mUploads {};
+    size_t mPending {};
+
+    // decodes submitted and not yet moved to mUploads, these still hold a surface even
+    // when Remove already took their slot out of mPending
+    size_t mDecoding {};
 
     static inline string mSubsystems = "SDL_image";
 };
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "pch.h"
+#include "Miscellaneous.h"
+#include "FileMapped.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+FileMapped::FileMapped(const string& file) {
+    Open(file);
+}
+
+FileMapped::FileMapped(FileMapped&& fileMapped) noexcept {
+    *this = move(fileMapped);
+}
+
+FileMapped::~FileMapped() {
+    Close();
+}
+
+FileMapped& FileMapped::operator=(FileMapped&& fileMapped) noexcept {
+    if (this != &fileMapped) {
+        Close();
+
+        swap(mData, fileMapped.mData);
+        swap(mSize, fileMapped.mSize);
+#ifdef _WIN32
+        swap(mFile, fileMapped.mFile);
+        swap(mMapping, fileMapped.mMapping);
+#endif // _WIN32
+    }
+
+    return *this;
+}
+
+#ifdef _WIN32
+bool FileMapped::Open(const string& file) {
+    Close();
+
+    const auto handleFile = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LOG_AND_RETURN_IF(handleFile == INVALID_HANDLE_VALUE, "The file \"" + file + "\" could not be opened! Error: " + to_string(GetLastError()) + '.', LOG_TYPE_WARNING, false);
+    mFile = handleFile;
+
+    LARGE_INTEGER size {};
+    if (!GetFileSizeEx(handleFile, &size) || !size.QuadPart) {
+        LOG("The file \"" + file + "\" is empty or its size could not be read!", LOG_TYPE_WARNING);
+        Close();
+        return false;
+    }
+
+    mMapping = CreateFileMappingA(handleFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mMapping) {
+        mData = (const uint8_t*)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+    }
+
+    if (!mData) {
+        LOG("The file \"" + file + "\" could not be mapped! Error: " + to_string(GetLastError()) + '.', LOG_TYPE_WARNING);
+        Close();
+        return false;
+    }
+
+    mSize = (size_t)size.QuadPart;
+    return true;
+}
+
+void FileMapped::Close() {
+    if (mData) {
+        UnmapViewOfFile(mData);
+    }
+
+    if (mMapping) {
+        CloseHandle(mMapping);
+    }
+
+    if (mFile) {
+        CloseHandle(mFile);
+    }
+
+    mData = nullptr;
+    mSize = 0;
+    mMapping = nullptr;
+    mFile = nullptr;
+}
+
+size_t FileMapped::GetPageSize() {
+    SYSTEM_INFO info {};
+    GetSystemInfo(&info);
+
+    return info.dwPageSize;
+}
+#else
+bool FileMapped::Open(const string& file) {
+    Close();
+
+    const auto descriptor = open(file.c_str(), O_RDONLY);
+    LOG_AND_RETURN_IF(descriptor < 0, "The file \"" + file + "\" could not be opened! Error: " + strerror(errno) + '.', LOG_TYPE_WARNING, false);
+
+    struct stat status {};
+    if (fstat(descriptor, &status) || !status.st_size) {
+        LOG("The file \"" + file + "\" is empty or its size could not be read!", LOG_TYPE_WARNING);
+        close(descriptor);
+        return false;
+    }
+
+    // the mapping keeps its own reference to the file
+    const auto data = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+
+    LOG_AND_RETURN_IF(data == MAP_FAILED, "The file \"" + file + "\" could not be mapped! Error: " + strerror(errno) + '.', LOG_TYPE_WARNING, false);
+
+    mData = (const uint8_t*)data;
+    mSize = (size_t)status.st_size;
+    return true;
+}
+
+void FileMapped::Close() {
+    if (mData) {
+        munmap((void*)mData, mSize);
+    }
+
+    mData = nullptr;
+    mSize = 0;
+}
+
+size_t FileMapped::GetPageSize() {
+    return (size_t)sysconf(_SC_PAGESIZE);
+}
+#endif // _WIN32
+
+bool FileMapped::IsOpen() const {
+    return mData;
+}
+
+const uint8_t* FileMapped::GetData() const {
+    return mData;
+}
+
+size_t FileMapped::GetSize() const {
+    return mSize;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+// Read-only view of a whole file mapped into memory. The pages come straight from the
+// page cache, so every process mapping the same file shares them and nothing is copied.
+class FileMapped {
+public:
+    FileMapped() = default;
+
+    FileMapped(const string& file);
+
+    FileMapped(const FileMapped&) = delete;
+
+    FileMapped(FileMapped&& fileMapped) noexcept;
+
+    ~FileMapped();
+
+    FileMapped& operator=(const FileMapped&) = delete;
+
+    FileMapped& operator=(FileMapped&& fileMapped) noexcept;
+
+    bool Open(const string& file);
+
+    void Close();
+
+    bool IsOpen() const;
+
+    const uint8_t* GetData() const;
+
+    size_t GetSize() const;
+
+    static size_t GetPageSize();
+
+private:
+    const uint8_t* mData = nullptr;
+    size_t mSize {};
+
+#ifdef _WIN32
+    void* mFile = nullptr;
+    void* mMapping = nullptr;
+#endif // _WIN32
+};
\ No newline at end of file
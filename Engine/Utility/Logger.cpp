@@ -1,21 +1,198 @@
 #include "pch.h"
 #include "Logger.h"
 
+Logger::Logger() {
+    Start();
+}
+
 Logger::Logger(const string& file, const bool logToBothStreams)
     : mStreamLogBoth(logToBothStreams) {
     mStream.open(file);
+
+    Start();
+}
+
+Logger::~Logger() {
+    {
+        lock_guard lock(mMutex);
+        mIsStopping = true;
+    }
+    mWake.notify_one();
+
+    if (mWriter.joinable()) {
+        mWriter.join();
+    }
+}
+
+void Logger::Flush() {
+    const auto target = mEnqueued.load(memory_order_acquire);
+
+    unique_lock lock(mMutex);
+    mFlushWaiters++;
+    mIsSleeping.store(false, memory_order_relaxed);
+    mWake.notify_one();
+    mFlushed.wait(lock, [&] { return mWritten >= target; });
+    mFlushWaiters--;
+}
+
+void Logger::Start() {
+    mSlots = make_unique<Slot[]>(mSlotCount);
+    for (size_t i = 0; i < mSlotCount; i++) {
+        mSlots[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    mWriter = thread(&Logger::Run, this);
+}
+
+void Logger::Enqueue(const string_view& text, const Type type, const Color color) {
+    // a slot is free for position p when its sequence is p and holds a record when it is p + 1
+    Slot* slot = nullptr;
+    auto position = mEnqueued.load(memory_order_relaxed);
+    while (true) {
+        slot = &mSlots[position % mSlotCount];
+
+        const auto difference = (intptr_t)slot->sequence.load(memory_order_acquire) - (intptr_t)position;
+        if (!difference) {
+            if (mEnqueued.compare_exchange_weak(position, position + 1, memory_order_relaxed)) {
+                break;
+            }
+        } else if (difference < 0) {
+            // the ring is full so wait for the writer instead of dropping the record
+            Wake();
+            this_thread::yield();
+            position = mEnqueued.load(memory_order_relaxed);
+        } else {
+            position = mEnqueued.load(memory_order_relaxed);
+        }
+    }
+
+    slot->type = type;
+    slot->color = color;
+    if (text.size() <= mSlotTextSize) {
+        slot->size = (uint8_t)text.size();
+        text.copy(slot->text, text.size());
+    } else {
+        slot->size = 0;
+        slot->overflow.assign(text);
+    }
+
+    // sequentially consistent, like the writer's flag and its last look, see Wake
+    slot->sequence.store(position + 1, memory_order_seq_cst);
+
+    Wake();
+}
+
+void Logger::Wake() {
+    // either the writer sees the record on its last look at the ring or this sees it sleeping,
+    // so a busy writer costs producers no lock at all
+    if (!mIsSleeping.load(memory_order_seq_cst)) {
+        return;
+    }
+
+    {
+        lock_guard lock(mMutex);
+        mIsSleeping.store(false, memory_order_relaxed);
+    }
+    mWake.notify_one();
+}
+
+bool Logger::Dequeue(string& batch) {
+    const auto position = mDequeued.load(memory_order_relaxed);
+    auto& slot = mSlots[position % mSlotCount];
+    if (slot.sequence.load(memory_order_acquire) != position + 1) {
+        return false;
+    }
+
+    Format(batch, slot);
+    slot.overflow.clear();
+
+    slot.sequence.store(position + mSlotCount, memory_order_release);
+    mDequeued.store(position + 1, memory_order_release);
+
+    return true;
+}
+
+bool Logger::IsReady() const {
+    const auto position = mDequeued.load(memory_order_relaxed);
+    return mSlots[position % mSlotCount].sequence.load(memory_order_seq_cst) == position + 1;
+}
+
+void Logger::Format(string& batch, const Slot& slot) {
+    batch += mReset;
+
+    auto typeAsInt = (uint8_t)slot.type;
+    if (typeAsInt > (uint8_t)Type::ERROR) {
+        typeAsInt = (uint8_t)Type::NONE;
+    }
+    const auto& typePair = mTypes[typeAsInt];
+
+    const auto colorAsInt = (int16_t)slot.color;
+    if (colorAsInt > (uint8_t)Color::NONE && colorAsInt < (uint8_t)Color::NONE2) {
+        batch += mBegin + to_string(colorAsInt) + mEnd;
+    } else if (typeAsInt != (uint8_t)Type::NONE) {
+        batch += mBegin + to_string((int16_t)typePair.second) + mEnd;
+    }
+
+    if (typeAsInt != (uint8_t)Type::NONE) {
+        batch += typePair.first + ' ';
+    }
+
+    if (slot.overflow.empty()) {
+        batch.append(slot.text, slot.size);
+    } else {
+        batch += slot.overflow;
+    }
+
+    batch += mReset;
 }
 
-void Logger::Write(const stringstream& stream) {
+void Logger::Write(const string& batch) {
     if (mStream.is_open()) {
         if (mStream) {
-            mStream << stream.str();
+            mStream << batch;
+            mStream.flush();
         }
 
         if (mStreamLogBoth) {
-            clog << stream.str();
+            clog << batch;
         }
     } else {
-        clog << stream.str();
+        clog << batch;
+    }
+}
+
+void Logger::Run() {
+    string batch {};
+    while (true) {
+        batch.clear();
+        for (size_t i = 0; i < mSlotCount && Dequeue(batch); i++);
+
+        if (!batch.empty()) {
+            Write(batch);
+        }
+
+        unique_lock lock(mMutex);
+        mWritten = mDequeued.load(memory_order_relaxed);
+        if (mFlushWaiters) {
+            mFlushed.notify_all();
+        }
+
+        if (!batch.empty()) {
+            continue;
+        }
+
+        if (mIsStopping) {
+            break;
+        }
+
+        // sleeps without a timeout, the first record after this look wakes it through Wake
+        mIsSleeping.store(true, memory_order_seq_cst);
+        if (IsReady()) {
+            mIsSleeping.store(false, memory_order_relaxed);
+            continue;
+        }
+
+        mWake.wait(lock, [&] { return !mIsSleeping.load(memory_order_relaxed) || mIsStopping; });
+        mIsSleeping.store(false, memory_order_relaxed);
     }
 }
@@ -1,5 +1,20 @@
 #pragma once
 
+#include <condition_variable>
+#include <type_traits>
+#include <string_view>
+#include <charconv>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <mutex>
+using namespace std;
+
+// records below this level are compiled out of the LOG macro
+#ifndef LOGGER_LEVEL
+#define LOGGER_LEVEL 0
+#endif // LOGGER_LEVEL
+
 class Logger {
 public:
     enum class Type : uint8_t {
@@ -11,7 +26,7 @@ public:
 
     enum class Color : uint8_t {
         NONE,
-        FG_BLACK = 30Ui8,
+        FG_BLACK = 30,
         FG_RED,
         FG_GREEN,
         FG_YELLOW,
@@ -19,7 +34,7 @@ public:
         FG_MAGENTA,
         FG_CYAN,
         FG_WHITE,
-        BG_BLACK = 40Ui8,
+        BG_BLACK = 40,
         BG_RED,
         BG_GREEN,
         BG_YELLOW,
@@ -30,35 +45,38 @@ public:
         NONE2
     };
 
-    Logger() = default;
+    static constexpr Type mLevel = Type(LOGGER_LEVEL);
+
+    Logger();
 
     Logger(const string& file, const bool logToBothStreams = false);
 
-    template<typename T>
-    void Log(const T& data, const Type type = Type::NONE, const Color color = Color::NONE) {
-        stringstream stream {};
-        stream << mReset;
+    ~Logger();
 
-        auto typeAsInt = (uint8_t)type;
-        if (typeAsInt < (uint8_t)Type::NONE && typeAsInt >(uint8_t)Type::ERROR) {
-            typeAsInt = (uint8_t)Type::NONE;
-        }
-        const auto& typePair = mTypes[typeAsInt];
+    static constexpr bool IsEnabled(const Type type) {
+        return (uint8_t)type >= (uint8_t)mLevel;
+    }
 
-        const auto colorAsInt = (int16_t)color;
-        if (colorAsInt > (uint8_t)Color::NONE && colorAsInt < (uint8_t)Color::NONE2) {
-            stream << mBegin << colorAsInt << mEnd;
-        } else if (typeAsInt != (uint8_t)Type::NONE) {
-            stream << mBegin << (int16_t)typePair.second << mEnd;
+    // only the text is produced on the calling thread, the writer thread decorates and writes it
+    template<typename T>
+    void Log(const T& data, const Type type = Type::NONE, const Color color = Color::NONE) {
+        if (!IsEnabled(type)) {
+            return;
         }
 
-        if (typeAsInt != (uint8_t)Type::NONE) {
-            stream << typePair.first << ' ';
+        if constexpr (is_convertible_v<const T&, string_view>) {
+            Enqueue(string_view(data), type, color);
+        } else if constexpr (is_same_v<T, char>) {
+            Enqueue(string_view(&data, 1), type, color);
+        } else if constexpr (mIsNumber<T>) {
+            char buffer[64] {};
+            const auto result = to_chars(buffer, buffer + sizeof(buffer), data);
+            Enqueue(string_view(buffer, result.ptr - buffer), type, color);
+        } else {
+            stringstream stream {};
+            stream << data;
+            Enqueue(stream.str(), type, color);
         }
-
-        stream << data << mReset;
-
-        Write(stream);
     }
 
     template<typename T>
@@ -68,12 +86,62 @@ public:
         return *this;
     }
 
+    // blocks until everything logged before the call is written
+    void Flush();
+
 private:
-    void Write(const stringstream& stream);
+    static constexpr size_t mSlotCount = 1024;
+    static constexpr size_t mSlotTextSize = 224;
+
+    // what to_chars prints the way a stream would, bool and the character types go to the stream
+    template<typename T>
+    static constexpr bool mIsNumber = (is_integral_v<T> && !is_same_v<T, bool> && !is_same_v<T, char> &&
+        !is_same_v<T, signed char> && !is_same_v<T, unsigned char> && !is_same_v<T, wchar_t> &&
+        !is_same_v<T, char16_t> && !is_same_v<T, char32_t>) || is_same_v<T, float> || is_same_v<T, double>;
+
+    struct Slot {
+        atomic<size_t> sequence {};
+
+        Type type = Type::NONE;
+        Color color = Color::NONE;
+
+        uint8_t size {};
+        char text[mSlotTextSize] {};
+        // only used by records that do not fit in text
+        string overflow {};
+    };
+
+    void Enqueue(const string_view& text, const Type type, const Color color);
+    bool Dequeue(string& batch);
+    bool IsReady() const;
+
+    // wakes the writer if it went to sleep, called after publishing a record
+    void Wake();
+
+    void Format(string& batch, const Slot& slot);
+    void Write(const string& batch);
+
+    void Start();
+    void Run();
 
     ofstream mStream {};
     bool mStreamLogBoth = false;
 
+    unique_ptr<Slot[]> mSlots {};
+    atomic<size_t> mEnqueued {};
+    atomic<size_t> mDequeued {};
+
+    mutex mMutex {};
+    condition_variable mWake {};
+    condition_variable mFlushed {};
+    // set by the writer before its last look at the ring, cleared by whoever wakes it
+    atomic<bool> mIsSleeping {};
+    bool mIsStopping = false;
+    size_t mFlushWaiters {};
+    size_t mWritten {};
+
+    thread mWriter {};
+
     static inline vector<pair<string, Color>> mTypes {
       { "[NONE]", Color::NONE },
       { "[INFO]", Color::FG_CYAN },
@@ -0,0 +1,59 @@
+#include "pch.h"
+#include "Memory.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+
+#pragma comment(lib, "psapi.lib")
+
+static bool GetCounters(PROCESS_MEMORY_COUNTERS& counters) {
+    return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+}
+
+size_t Memory::GetResident() {
+    PROCESS_MEMORY_COUNTERS counters {};
+    return GetCounters(counters) ? counters.WorkingSetSize : 0;
+}
+
+size_t Memory::GetResidentPeak() {
+    PROCESS_MEMORY_COUNTERS counters {};
+    return GetCounters(counters) ? counters.PeakWorkingSetSize : 0;
+}
+
+bool Memory::ResetResidentPeak() {
+    return false;
+}
+#else
+// reads a "Name:   1234 kB" line of /proc/self/status
+static size_t GetStatus(const string& name) {
+    ifstream stream("/proc/self/status");
+
+    string line {};
+    while (getline(stream, line)) {
+        if (!line.compare(0, name.size(), name) && line[name.size()] == ':') {
+            return stoull(line.substr(name.size() + 1)) * 1024;
+        }
+    }
+
+    return 0;
+}
+
+size_t Memory::GetResident() {
+    return GetStatus("VmRSS");
+}
+
+size_t Memory::GetResidentPeak() {
+    return GetStatus("VmHWM");
+}
+
+bool Memory::ResetResidentPeak() {
+    // 5 resets the peak resident set size to the current one
+    ofstream stream("/proc/self/clear_refs");
+    stream << "5";
+
+    return (bool)stream.flush();
+}
+#endif // _WIN32
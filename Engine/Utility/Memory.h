@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+using namespace std;
+
+// What the operating system reports about the memory of this process
+class Memory {
+public:
+    // bytes, 0 when the platform cannot tell
+    static size_t GetResident();
+
+    static size_t GetResidentPeak();
+
+    // starts GetResidentPeak over from the current usage, false where the platform cannot
+    static bool ResetResidentPeak();
+};
\ No newline at end of file
@@ -1,3 +1,8 @@
 #include "pch.h"
 #include "Miscellaneous.h"
 
+#ifdef _DEBUG
+Logger logger {};
+#else
+Logger logger("Test.log");
+#endif // _DEBUG
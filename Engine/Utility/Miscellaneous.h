@@ -5,13 +5,17 @@
 #define GET_LOCATION string(string("file \"") + __FILE__ + "\" in function \"" + __func__ + "\" at line \"" + to_string(__LINE__) + '"')
 #define GET_PARAMETER(param) string(string(typeid(param).name()) + " \"" + #param + "\" parameter from " + GET_LOCATION)
 
-#ifdef _DEBUG
-static Logger logger {};
-#else
-static Logger logger("Test.log");
-#endif // _DEBUG
+// the one logger of the process, defined in Miscellaneous.cpp
+extern Logger logger;
 
-#define LOG(message, type) logger.Log(message, Logger::Type(type))
+// the message is not even evaluated when the type is compiled out
+#define LOG(message, type) \
+do { \
+	if constexpr (Logger::IsEnabled(Logger::Type(type))) { \
+		logger.Log(message, Logger::Type(type)); \
+	} \
+} while (false)
+#define LOG_TYPE_INFO Logger::Type::INFO
 #define LOG_TYPE_WARNING Logger::Type::WARNING
 #define LOG_TYPE_ERROR Logger::Type::ERROR
 
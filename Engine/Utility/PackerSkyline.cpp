@@ -0,0 +1,122 @@
+#include "pch.h"
+#include "PackerSkyline.h"
+
+PackerSkyline::PackerSkyline(const uint32_t width, const uint32_t height) {
+    Reset(width, height);
+}
+
+void PackerSkyline::Reset(const uint32_t width, const uint32_t height) {
+    mWidth = width;
+    mHeight = height;
+    mUsedWidth = 0;
+    mUsedArea = 0;
+
+    mSkyline.assign(1, { 0, 0, width });
+}
+
+bool PackerSkyline::Insert(const uint32_t width, const uint32_t height, uint32_t& x, uint32_t& y) {
+    if (!width || !height) {
+        return false;
+    }
+
+    // lowest top first, then the narrowest segment to leave the wide ones for wide rectangles
+    auto best = mSkyline.size();
+    uint32_t bestTop = UINT32_MAX, bestWidth = UINT32_MAX, bestY {};
+
+    for (size_t i = 0; i < mSkyline.size(); i++) {
+        uint32_t fitY {};
+        if (!Fit(i, width, height, fitY)) {
+            continue;
+        }
+
+        const auto top = fitY + height;
+        if (top < bestTop || (top == bestTop && mSkyline[i].width < bestWidth)) {
+            best = i;
+            bestTop = top;
+            bestWidth = mSkyline[i].width;
+            bestY = fitY;
+        }
+    }
+
+    if (best == mSkyline.size()) {
+        return false;
+    }
+
+    x = mSkyline[best].x;
+    y = bestY;
+
+    // the new segment covers the start of the ones it sits on, cut them back or drop them
+    mSkyline.insert(mSkyline.begin() + best, { x, y + height, width });
+
+    const auto right = x + width;
+    for (auto i = best + 1; i < mSkyline.size();) {
+        auto& segment = mSkyline[i];
+        if (segment.x >= right) {
+            break;
+        }
+
+        const auto segmentRight = segment.x + segment.width;
+        if (segmentRight <= right) {
+            mSkyline.erase(mSkyline.begin() + i);
+            continue;
+        }
+
+        segment.width = segmentRight - right;
+        segment.x = right;
+        break;
+    }
+
+    for (size_t i = 1; i < mSkyline.size();) {
+        if (mSkyline[i - 1].y == mSkyline[i].y) {
+            mSkyline[i - 1].width += mSkyline[i].width;
+            mSkyline.erase(mSkyline.begin() + i);
+        } else {
+            i++;
+        }
+    }
+
+    mUsedWidth = max(mUsedWidth, right);
+    mUsedArea += (uint64_t)width * height;
+
+    return true;
+}
+
+uint32_t PackerSkyline::GetWidth() const {
+    return mWidth;
+}
+
+uint32_t PackerSkyline::GetHeight() const {
+    return mHeight;
+}
+
+uint32_t PackerSkyline::GetUsedHeight() const {
+    uint32_t height {};
+    for (const auto& segment : mSkyline) {
+        height = max(height, segment.y);
+    }
+
+    return height;
+}
+
+uint32_t PackerSkyline::GetUsedWidth() const {
+    return mUsedWidth;
+}
+
+double PackerSkyline::GetOccupancy() const {
+    return mWidth && mHeight ? (double)mUsedArea / ((double)mWidth * (double)mHeight) : 0.;
+}
+
+bool PackerSkyline::Fit(const size_t index, const uint32_t width, const uint32_t height, uint32_t& y) const {
+    const auto x = mSkyline[index].x;
+    if (width > mWidth - x) {
+        return false;
+    }
+
+    // the rectangle rests on the highest of the segments under it
+    y = 0;
+    for (auto i = index; i < mSkyline.size() && mSkyline[i].x < x + width; i++) {
+        y = max(y, mSkyline[i].y);
+    }
+
+    return height <= mHeight && y <= mHeight - height;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+// Packs rectangles into one page by keeping only its skyline, the top edge of what is placed so
+// far. Every rectangle goes where its top ends lowest, which keeps the skyline flat and the
+// page dense for the similar sized tiles it is meant for.
+class PackerSkyline {
+public:
+    PackerSkyline(const uint32_t width, const uint32_t height);
+
+    void Reset(const uint32_t width, const uint32_t height);
+
+    // false when the rectangle fits nowhere, the page is left untouched then
+    bool Insert(const uint32_t width, const uint32_t height, uint32_t& x, uint32_t& y);
+
+    uint32_t GetWidth() const;
+
+    uint32_t GetHeight() const;
+
+    // the highest point of the skyline, everything placed lies above it
+    uint32_t GetUsedHeight() const;
+
+    // the rightmost edge of anything placed
+    uint32_t GetUsedWidth() const;
+
+    // covered area over page area
+    double GetOccupancy() const;
+
+private:
+    struct Segment {
+        uint32_t x {};
+        uint32_t y {};
+        uint32_t width {};
+    };
+
+    // where a rectangle starting at the segment would sit, false if it leaves the page
+    bool Fit(const size_t index, const uint32_t width, const uint32_t height, uint32_t& y) const;
+
+    uint32_t mWidth {};
+    uint32_t mHeight {};
+    uint32_t mUsedWidth {};
+    uint64_t mUsedArea {};
+
+    // left to right, every segment starts where the previous one ends
+    vector<Segment> mSkyline {};
+};
\ No newline at end of file
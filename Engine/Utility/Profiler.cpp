@@ -0,0 +1,261 @@
+#include "pch.h"
+#include "Profiler.h"
+
+Profiler profiler {};
+
+Profiler::Zone::Zone(const char* name)
+    : mName(name) {
+    if (profiler.IsRecording()) {
+        mStart = profiler.GetNow();
+    }
+}
+
+Profiler::Zone::~Zone() {
+    if (mStart >= 0) {
+        profiler.Record({ mName, mStart, profiler.GetNow() - mStart });
+    }
+}
+
+Profiler::Profiler(const size_t frameHistory /* = 240 */)
+    : mFrameHistory(max<size_t>(frameHistory, 1)),
+    mStart(chrono::steady_clock::now()) {}
+
+void Profiler::SetRecording(const bool isRecording) {
+    lock_guard lock(mMutex);
+
+    // the pause must not show up as one long frame
+    mFrameLast = -1;
+    mIsRecording.store(isRecording, memory_order_relaxed);
+}
+
+void Profiler::Count(const char* name, const double value) {
+    if (IsRecording()) {
+        Record({ name, GetNow(), 0, value, Type::COUNTER });
+    }
+}
+
+void Profiler::EndFrame() {
+    if (!IsRecording()) {
+        return;
+    }
+
+    const auto now = GetNow();
+    auto frameLast = now;
+
+    {
+        lock_guard lock(mMutex);
+
+        swap(frameLast, mFrameLast);
+        if (frameLast >= 0) {
+            Push(mFrames, (double)(now - frameLast) / 1e6);
+        }
+
+        Fold();
+    }
+
+    // outside the lock, the first record of a thread takes it to make the buffer
+    if (frameLast >= 0) {
+        Record({ "Frame", frameLast, now - frameLast, 0., Type::FRAME });
+    }
+}
+
+void Profiler::Fold() {
+    const auto getHistory = [](map<string, History, less<>>& histories, const char* name) -> History& {
+        auto it = histories.find(string_view(name));
+        if (it == histories.end()) {
+            it = histories.emplace(name, History {}).first;
+        }
+
+        return it->second;
+    };
+
+    for (auto& buffer : mBuffers) {
+        lock_guard lockBuffer(buffer->access);
+
+        // events overwritten before they were folded are lost to the statistics, not just a frame late
+        const auto first = max(buffer->eventsFolded, buffer->eventsRecorded - min(buffer->eventsRecorded, mEventsMax));
+        for (size_t i = first; i < buffer->eventsRecorded; i++) {
+            const auto& event = buffer->events[i % mEventsMax];
+            if (event.type == Type::COUNTER) {
+                auto& history = getHistory(mCounters, event.name);
+                history.current = event.value;
+                history.isCurrent = true;
+            } else if (event.type == Type::ZONE) {
+                // a zone hit several times in a frame counts once, with the times added up
+                auto& history = getHistory(mZones, event.name);
+                history.current += (double)event.duration / 1e6;
+                history.isCurrent = true;
+            }
+        }
+
+        buffer->eventsFolded = buffer->eventsRecorded;
+    }
+
+    // zones that did not run this frame keep their history as it was
+    for (auto histories : { &mZones, &mCounters }) {
+        for (auto& [name, history] : *histories) {
+            if (history.isCurrent) {
+                Push(history, history.current);
+
+                history.current = 0.;
+                history.isCurrent = false;
+            }
+        }
+    }
+}
+
+bool Profiler::GetStatistics(const string_view& name, Statistics& statistics) const {
+    lock_guard lock(mMutex);
+
+    const auto it = mZones.find(name);
+    if (it == mZones.end()) {
+        return false;
+    }
+
+    statistics = it->second.statistics;
+    return true;
+}
+
+bool Profiler::GetCounterStatistics(const string_view& name, Statistics& statistics) const {
+    lock_guard lock(mMutex);
+
+    const auto it = mCounters.find(name);
+    if (it == mCounters.end()) {
+        return false;
+    }
+
+    statistics = it->second.statistics;
+    return true;
+}
+
+Profiler::Statistics Profiler::GetFrameStatistics() const {
+    lock_guard lock(mMutex);
+
+    return mFrames.statistics;
+}
+
+bool Profiler::Export(const string& file) const {
+    ofstream stream(file);
+    if (!stream) {
+        return false;
+    }
+
+    lock_guard lock(mMutex);
+
+    stream << "{\"traceEvents\":[";
+
+    bool isFirst = true;
+    for (const auto& buffer : mBuffers) {
+        lock_guard lockBuffer(buffer->access);
+
+        stream << (isFirst ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->thread
+               << ",\"args\":{\"name\":\"Thread " << buffer->thread << "\"}}";
+        isFirst = false;
+
+        // oldest first, the trace wants microseconds
+        const auto first = buffer->eventsRecorded - buffer->events.size();
+        for (size_t i = first; i < buffer->eventsRecorded; i++) {
+            const auto& event = buffer->events[i % mEventsMax];
+            stream << ",\n{\"name\":";
+            WriteName(stream, event.name);
+
+            if (event.type == Type::COUNTER) {
+                stream << ",\"ph\":\"C\",\"ts\":" << (double)event.start / 1e3 << ",\"pid\":0,\"tid\":" << buffer->thread
+                       << ",\"args\":{\"value\":" << event.value << "}}";
+            } else {
+                stream << ",\"ph\":\"X\",\"ts\":" << (double)event.start / 1e3 << ",\"dur\":" << (double)event.duration / 1e3
+                       << ",\"pid\":0,\"tid\":" << buffer->thread << "}";
+            }
+        }
+    }
+
+    stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return (bool)stream;
+}
+
+void Profiler::Clear() {
+    lock_guard lock(mMutex);
+
+    for (auto& buffer : mBuffers) {
+        lock_guard lockBuffer(buffer->access);
+
+        buffer->events.clear();
+        buffer->eventsRecorded = 0;
+        buffer->eventsFolded = 0;
+    }
+
+    mZones.clear();
+    mCounters.clear();
+    mFrames = {};
+    mFrameLast = -1;
+}
+
+int64_t Profiler::GetNow() const {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - mStart).count();
+}
+
+Profiler::Buffer& Profiler::GetBuffer() {
+    // the buffers belong to the profiler, so the events of a finished thread are still exported
+    thread_local pair<const Profiler*, Buffer*> owned {};
+    if (owned.first == this) {
+        return *owned.second;
+    }
+
+    lock_guard lock(mMutex);
+
+    auto& buffer = mBuffers.emplace_back(make_unique<Buffer>());
+    buffer->thread = mBuffers.size() - 1;
+
+    owned = { this, buffer.get() };
+    return *buffer;
+}
+
+void Profiler::Record(const Event& event) {
+    auto& buffer = GetBuffer();
+    lock_guard lock(buffer.access);
+
+    if (buffer.events.size() < mEventsMax) {
+        buffer.events.push_back(event);
+    } else {
+        buffer.events[buffer.eventsRecorded % mEventsMax] = event;
+    }
+
+    buffer.eventsRecorded++;
+}
+
+void Profiler::Push(History& history, const double sample) {
+    if (history.samples.size() < mFrameHistory) {
+        history.samples.push_back(sample);
+    } else {
+        history.samples[history.next] = sample;
+    }
+    history.next = (history.next + 1) % mFrameHistory;
+
+    mSorted.assign(history.samples.begin(), history.samples.end());
+    sort(mSorted.begin(), mSorted.end());
+
+    auto& statistics = history.statistics;
+    statistics.min = mSorted.front();
+    statistics.average = 0.;
+    for (const auto value : mSorted) {
+        statistics.average += value;
+    }
+    statistics.average /= (double)mSorted.size();
+    // the smallest sample at or above 99% of them
+    statistics.p99 = mSorted[(mSorted.size() * 99 + 99) / 100 - 1];
+    statistics.last = sample;
+    statistics.frames = mSorted.size();
+}
+
+void Profiler::WriteName(ostream& stream, const char* name) {
+    stream << '"';
+    for (auto character = name; *character; character++) {
+        if (*character == '"' || *character == '\\') {
+            stream << '\\' << *character;
+        } else if ((unsigned char)*character >= 0x20) {
+            stream << *character;
+        }
+    }
+    stream << '"';
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <string_view>
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <map>
+using namespace std;
+
+// set to 0 to compile every zone and counter out of the build
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif // PROFILER_ENABLED
+
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+
+// names must outlive the profiler, string literals and __func__ do
+#if PROFILER_ENABLED
+#define PROFILE_SCOPE(name) Profiler::Zone PROFILER_CONCAT(profilerZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__func__)
+#define PROFILE_COUNTER(name, value) profiler.Count(name, (double)(value))
+#define PROFILE_FRAME() profiler.EndFrame()
+#else
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_COUNTER(name, value)
+#define PROFILE_FRAME()
+#endif // PROFILER_ENABLED
+
+class Profiler {
+public:
+    struct Statistics {
+        // in milliseconds for zones and frames, in the counted unit for counters
+        double min {};
+        double average {};
+        double p99 {};
+        double last {};
+        size_t frames {};
+    };
+
+    class Zone {
+    public:
+        Zone(const char* name);
+        ~Zone();
+
+        Zone(const Zone&) = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char* mName = nullptr;
+        int64_t mStart = -1;
+    };
+
+    Profiler(const size_t frameHistory = 240);
+
+    // nothing is recorded until this is on, so a compiled in zone costs one relaxed load
+    void SetRecording(const bool isRecording);
+    bool IsRecording() const {
+        return mIsRecording.load(memory_order_relaxed);
+    }
+
+    void Count(const char* name, const double value);
+
+    // folds the zones and counters recorded since the last call into the frame history
+    void EndFrame();
+
+    bool GetStatistics(const string_view& name, Statistics& statistics) const;
+    bool GetCounterStatistics(const string_view& name, Statistics& statistics) const;
+    Statistics GetFrameStatistics() const;
+
+    // writes what was recorded since the last Clear as a Chrome trace (chrome://tracing, Perfetto),
+    // the most recent mEventsMax events of every thread
+    bool Export(const string& file) const;
+
+    void Clear();
+
+private:
+    enum class Type : uint8_t {
+        ZONE,
+        COUNTER,
+        FRAME
+    };
+
+    struct Event {
+        const char* name = nullptr;
+        int64_t start {};
+        int64_t duration {};
+        double value {};
+        Type type = Type::ZONE;
+    };
+
+    // Every thread appends to its own buffer, the lock is only contended while a frame is folded.
+    // The events are a ring that overwrites the oldest once full, so the trace keeps the latest
+    // ones and the statistics keep updating however long the process runs.
+    struct Buffer {
+        mutex access {};
+        vector<Event> events {};
+        // counted since the last Clear, the ring holds the last min(recorded, mEventsMax) of them
+        size_t eventsRecorded {};
+        size_t eventsFolded {};
+        size_t thread {};
+    };
+
+    struct History {
+        vector<double> samples {};
+        size_t next {};
+        double current {};
+        bool isCurrent = false;
+        Statistics statistics {};
+    };
+
+    // per thread, about 2.5 MiB and over a minute and a half of frames at 60 fps with 10 zones each
+    static constexpr size_t mEventsMax = (size_t)1 << 16;
+
+    int64_t GetNow() const;
+    Buffer& GetBuffer();
+
+    void Record(const Event& event);
+    void Fold();
+    void Push(History& history, const double sample);
+
+    static void WriteName(ostream& stream, const char* name);
+
+    const size_t mFrameHistory {};
+    const chrono::steady_clock::time_point mStart {};
+
+    atomic<bool> mIsRecording {};
+
+    mutable mutex mMutex {};
+    vector<unique_ptr<Buffer>> mBuffers {};
+
+    map<string, History, less<>> mZones {};
+    map<string, History, less<>> mCounters {};
+    History mFrames {};
+    int64_t mFrameLast = -1;
+    vector<double> mSorted {};
+};
+
+// the one profiler of the process, defined in Profiler.cpp
+extern Profiler profiler;
\ No newline at end of file
@@ -2,4 +2,27 @@
 #include "Random.h"
 
 Random::Random()
-    : mEngine(mGenerator()) {}
+    : mEngine(random_device {}()) {}
+
+Random::Random(const uint64_t seed, const uint64_t stream /* = 0 */) {
+    seed_seq sequence { (uint32_t)seed, (uint32_t)(seed >> 32), (uint32_t)stream, (uint32_t)(stream >> 32) };
+    mEngine.seed(sequence);
+}
+
+RandomCounter::RandomCounter(const uint64_t seed /* = 0 */, const uint64_t stream /* = 0 */)
+    : mKey(Mix(seed ^ Mix(stream + mGamma))) {}
+
+RandomCounter RandomCounter::Split(const uint64_t stream) const {
+    RandomCounter random {};
+    random.mKey = Mix(mKey ^ Mix(stream + mGamma));
+
+    return random;
+}
+
+void RandomCounter::Discard(const uint64_t count) {
+    mCounter += count;
+}
+
+uint64_t RandomCounter::GetCounter() const {
+    return mCounter;
+}
@@ -7,6 +7,8 @@ class Random {
 public:
     Random();
 
+    Random(const uint64_t seed, const uint64_t stream = 0);
+
     template<typename Integer>
     Integer GetInteger(
         const Integer min = numeric_limits<Integer>::min(),
@@ -24,6 +26,105 @@ public:
     }
 
 private:
-    random_device mGenerator;
     mt19937 mEngine;
+};
+
+// Counter-based generator in the style of SplitMix64: the n-th number of a stream is a pure
+// function of the stream's key and n, so a stream can be replayed, skipped ahead or split
+// into independent child streams without carrying any state besides two integers
+class RandomCounter {
+public:
+    using result_type = uint64_t;
+
+    RandomCounter(const uint64_t seed = 0, const uint64_t stream = 0);
+
+    static constexpr result_type min() {
+        return numeric_limits<result_type>::min();
+    }
+
+    static constexpr result_type max() {
+        return numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+        return Mix(mKey + mCounter++ * mGamma);
+    }
+
+    RandomCounter Split(const uint64_t stream) const;
+
+    void Discard(const uint64_t count);
+
+    uint64_t GetCounter() const;
+
+    template<typename Integer>
+    Integer GetInteger(
+        const Integer min = numeric_limits<Integer>::min(),
+        const Integer max = numeric_limits<Integer>::max()
+    ) {
+        const auto range = (uint64_t)max - (uint64_t)min + 1;
+        if (!range) {
+            return (Integer)(*this)();
+        }
+
+        // rejecting the values below the threshold keeps the modulo unbiased
+        const auto threshold = (0 - range) % range;
+        while (true) {
+            const auto value = (*this)();
+            if (value >= threshold) {
+                return (Integer)((uint64_t)min + value % range);
+            }
+        }
+    }
+
+    template<typename Real>
+    Real GetReal(const Real min = (Real)0, const Real max = (Real)1) {
+        return min + GetUnit<Real>() * (max - min);
+    }
+
+    template<typename Integer>
+    void FillInteger(
+        Integer* data,
+        const size_t count,
+        const Integer min = numeric_limits<Integer>::min(),
+        const Integer max = numeric_limits<Integer>::max()
+    ) {
+        for (size_t i = 0; i < count; i++) {
+            data[i] = GetInteger(min, max);
+        }
+    }
+
+    template<typename Real>
+    void FillReal(Real* data, const size_t count, const Real min = (Real)0, const Real max = (Real)1) {
+        // every value depends only on its own counter, so the loop carries no dependency
+        const auto scale = max - min;
+        for (size_t i = 0; i < count; i++) {
+            data[i] = min + ToUnit<Real>(Mix(mKey + (mCounter + i) * mGamma)) * scale;
+        }
+
+        mCounter += count;
+    }
+
+private:
+    static constexpr uint64_t Mix(uint64_t value) {
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    template<typename Real>
+    static constexpr Real ToUnit(const uint64_t value) {
+        // only as many high bits as the mantissa holds, so the result stays below 1
+        constexpr auto digits = numeric_limits<Real>::digits;
+        return (Real)(value >> (64 - digits)) * ((Real)1 / (Real)((uint64_t)1 << digits));
+    }
+
+    template<typename Real>
+    Real GetUnit() {
+        return ToUnit<Real>((*this)());
+    }
+
+    static constexpr uint64_t mGamma = 0x9E3779B97F4A7C15ull;
+
+    uint64_t mKey {};
+    uint64_t mCounter {};
 };
\ No newline at end of file
@@ -0,0 +1,13 @@
+#include "pch.h"
+#include "Stopwatch.h"
+
+Stopwatch::Stopwatch()
+    : mStart(chrono::steady_clock::now()) {}
+
+void Stopwatch::Restart() {
+    mStart = chrono::steady_clock::now();
+}
+
+double Stopwatch::GetSeconds() const {
+    return GetElapsed().count();
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <chrono>
+using namespace std;
+
+class Stopwatch {
+public:
+    Stopwatch();
+
+    void Restart();
+
+    template<typename Duration = chrono::duration<double>>
+    Duration GetElapsed() const {
+        return chrono::duration_cast<Duration>(chrono::steady_clock::now() - mStart);
+    }
+
+    double GetSeconds() const;
+
+private:
+    chrono::steady_clock::time_point mStart {};
+};
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "pch.h"
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(const size_t threads /* = thread::hardware_concurrency() */) {
+    const auto threadsCount = max<size_t>(threads, 1);
+
+    mThreads.reserve(threadsCount);
+    for (size_t i = 0; i < threadsCount; i++) {
+        mThreads.emplace_back(&ThreadPool::Work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard lock(mMutex);
+        mIsStopping = true;
+    }
+    mCondition.notify_all();
+
+    for (auto& thread : mThreads) {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::GetSize() const {
+    return mThreads.size();
+}
+
+void ThreadPool::Work() {
+    while (true) {
+        function<void()> task {};
+
+        {
+            unique_lock lock(mMutex);
+            mCondition.wait(lock, [this]() { return mIsStopping || !mTasks.empty(); });
+
+            if (mIsStopping && mTasks.empty()) {
+                return;
+            }
+
+            task = move(mTasks.front());
+            mTasks.pop();
+        }
+
+        task();
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <condition_variable>
+#include <type_traits>
+#include <functional>
+#include <exception>
+#include <future>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <queue>
+#include <mutex>
+using namespace std;
+
+class ThreadPool {
+public:
+    ThreadPool(const size_t threads = thread::hardware_concurrency());
+
+    ~ThreadPool();
+
+    template<typename Function>
+    auto Submit(Function&& function) -> future<invoke_result_t<Function>> {
+        using Result = invoke_result_t<Function>;
+
+        auto task = make_shared<packaged_task<Result()>>(forward<Function>(function));
+        auto result = task->get_future();
+
+        {
+            lock_guard lock(mMutex);
+            mTasks.emplace([task]() { (*task)(); });
+        }
+        mCondition.notify_one();
+
+        return result;
+    }
+
+    // Calls function(i) for every i in [0, count) and blocks until all of them returned,
+    // the calling thread takes indices too so it never sits idle while the workers run.
+    // The helpers use this frame, so an exception from any call stops handing out indices,
+    // waits for every helper and is only then rethrown, the first one when several threw.
+    template<typename Function>
+    void ForEach(const size_t count, Function&& function) {
+        atomic<size_t> next {};
+        const auto work = [&]() {
+            try {
+                for (auto i = next++; i < count; i = next++) {
+                    function(i);
+                }
+            } catch (...) {
+                next = count;
+                throw;
+            }
+        };
+
+        vector<future<void>> helpers {};
+        const auto helpersCount = count ? min(count - 1, mThreads.size()) : 0;
+        for (size_t i = 0; i < helpersCount; i++) {
+            helpers.push_back(Submit(work));
+        }
+
+        exception_ptr exception {};
+        try {
+            work();
+        } catch (...) {
+            exception = current_exception();
+        }
+
+        for (auto& helper : helpers) {
+            try {
+                helper.get();
+            } catch (...) {
+                if (!exception) {
+                    exception = current_exception();
+                }
+            }
+        }
+
+        if (exception) {
+            rethrow_exception(exception);
+        }
+    }
+
+    size_t GetSize() const;
+
+private:
+    void Work();
+
+    vector<thread> mThreads {};
+    queue<function<void()>> mTasks {};
+
+    mutex mMutex {};
+    condition_variable mCondition {};
+    bool mIsStopping = false;
+};
\ No newline at end of file
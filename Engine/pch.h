@@ -1,11 +1,8 @@
 #pragma once
 
-// SDL2
-#include "SDL.h"
-#include "SDL_image.h"
-
 // ATL
 #include <filesystem>
+#include <algorithm>
 #include <random>
 #include <vector>
 #include <string>
@@ -0,0 +1,3 @@
+#include "Game/pch.h"
+#include "Matrix.h"
+
@@ -0,0 +1,373 @@
+#pragma once
+
+#include <type_traits>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <new>
+using namespace std;
+
+// Hands out storage starting on an Alignment byte boundary, for vectors whose
+// elements must not share a cache line with whatever the heap put before them
+template<typename T, size_t Alignment>
+class AllocatorAligned {
+public:
+    static_assert(Alignment >= alignof(T) && !(Alignment & (Alignment - 1)), "Alignment must be a power of two!");
+
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = AllocatorAligned<U, Alignment>;
+    };
+
+    AllocatorAligned() = default;
+
+    template<typename U>
+    AllocatorAligned(const AllocatorAligned<U, Alignment>&) {}
+
+    T* allocate(const size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), align_val_t(Alignment)));
+    }
+
+    void deallocate(T* data, const size_t) {
+        ::operator delete(data, align_val_t(Alignment));
+    }
+
+    template<typename U>
+    bool operator==(const AllocatorAligned<U, Alignment>&) const {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const AllocatorAligned<U, Alignment>&) const {
+        return false;
+    }
+};
+
+// View over `size` elements placed `stride` elements apart, which makes
+// rows (stride 1) and columns (stride of the row) of a Matrix look alike
+template<typename T>
+class Span {
+public:
+    Span() = default;
+
+    Span(T* data, const size_t size, const size_t stride = 1)
+        : mData(data), mSize(size), mStride(stride) {}
+
+    T& operator[](const size_t index) const {
+        return mData[index * mStride];
+    }
+
+    T* GetData() const {
+        return mData;
+    }
+
+    size_t GetSize() const {
+        return mSize;
+    }
+
+    size_t GetStride() const {
+        return mStride;
+    }
+
+private:
+    T* mData = nullptr;
+    size_t mSize {};
+    size_t mStride {};
+};
+
+// Row-major matrix in a single cache line aligned allocation, rows are padded to whole
+// cache lines so bands of rows can be written from different threads without sharing lines
+template<typename T>
+class Matrix {
+public:
+    Matrix() = default;
+
+    Matrix(const size_t width, const size_t height, const T& value = {}) {
+        Resize(width, height, value);
+    }
+
+    // keeps the allocation whenever the new size fits in it
+    void Resize(const size_t width, const size_t height, const T& value = {}) {
+        constexpr auto lineElements = max<size_t>(mLine / sizeof(T), 1);
+
+        mWidth = width;
+        mHeight = height;
+        mStride = (width + lineElements - 1) / lineElements * lineElements;
+
+        mData.resize(mStride * mHeight);
+        Fill(value);
+    }
+
+    void Fill(const T& value) {
+        FillCells(mData.data(), mData.size(), value);
+    }
+
+    // clipped to the row, so callers may pass spans hanging off the edges
+    void FillRow(const size_t x, const size_t y, const size_t count, const T& value) {
+        if (y >= mHeight || x >= mWidth) {
+            return;
+        }
+
+        FillCells(&mData[y * mStride + x], min(count, mWidth - x), value);
+    }
+
+    void Set(const size_t x, const size_t y, const T& value) {
+        if (x < mWidth && y < mHeight) {
+            mData[y * mStride + x] = value;
+        }
+    }
+
+    T* operator[](const size_t y) {
+        return &mData[y * mStride];
+    }
+
+    const T* operator[](const size_t y) const {
+        return &mData[y * mStride];
+    }
+
+    Span<T> GetRow(const size_t y) {
+        return { &mData[y * mStride], mWidth };
+    }
+
+    Span<const T> GetRow(const size_t y) const {
+        return { &mData[y * mStride], mWidth };
+    }
+
+    Span<T> GetColumn(const size_t x) {
+        return { &mData[x], mHeight, mStride };
+    }
+
+    Span<const T> GetColumn(const size_t x) const {
+        return { &mData[x], mHeight, mStride };
+    }
+
+    T* GetData() {
+        return mData.data();
+    }
+
+    const T* GetData() const {
+        return mData.data();
+    }
+
+    size_t GetWidth() const {
+        return mWidth;
+    }
+
+    size_t GetHeight() const {
+        return mHeight;
+    }
+
+    size_t GetStride() const {
+        return mStride;
+    }
+
+    bool operator==(const Matrix<T>& matrix) const {
+        if (mWidth != matrix.mWidth || mHeight != matrix.mHeight) {
+            return false;
+        }
+
+        for (size_t y = 0; y < mHeight; y++) {
+            if (!equal((*this)[y], (*this)[y] + mWidth, matrix[y])) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool operator!=(const Matrix<T>& matrix) const {
+        return !(*this == matrix);
+    }
+
+private:
+    static void FillCells(T* cells, const size_t count, const T& value) {
+        if constexpr (sizeof(T) == 1 && is_trivially_copyable_v<T>) {
+            // long runs of byte cells go through memset, which stores whole vector registers at a time,
+            // short ones would only pay for the call
+            if (count >= mRunLong) {
+                uint8_t byte {};
+                memcpy(&byte, &value, 1);
+                memset(cells, byte, count);
+                return;
+            }
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            cells[i] = value;
+        }
+    }
+
+    static constexpr size_t mLine = 64;
+    static constexpr size_t mRunLong = 32;
+
+    vector<T, AllocatorAligned<T, mLine>> mData {};
+    size_t mWidth {};
+    size_t mHeight {};
+    size_t mStride {};
+};
+
+// Matrix of small unsigned values packed `Bits` to a 64 bit word, rows start on word boundaries
+// so a whole row, or 64 / Bits cells of it, can be read and written a word at a time,
+// with Bits = 1 it doubles as a bitplane of one layer
+template<size_t Bits>
+class MatrixPacked {
+public:
+    static_assert(Bits == 1 || Bits == 2 || Bits == 4 || Bits == 8, "Bits must divide a byte evenly!");
+
+    using Word = uint64_t;
+
+    static constexpr size_t mCellsPerWord = sizeof(Word) * 8 / Bits;
+    static constexpr Word mMask = ((Word)1 << Bits) - 1;
+
+    MatrixPacked() = default;
+
+    MatrixPacked(const size_t width, const size_t height, const uint8_t value = 0) {
+        Resize(width, height, value);
+    }
+
+    // keeps the allocation whenever the new size fits in it
+    void Resize(const size_t width, const size_t height, const uint8_t value = 0) {
+        mWidth = width;
+        mHeight = height;
+        mStride = (width + mCellsPerWord - 1) / mCellsPerWord;
+
+        mData.assign(mStride * mHeight, Replicate(value));
+    }
+
+    void Fill(const uint8_t value) {
+        fill(mData.begin(), mData.end(), Replicate(value));
+    }
+
+    uint8_t Get(const size_t x, const size_t y) const {
+        return (uint8_t)((mData[y * mStride + x / mCellsPerWord] >> GetShift(x)) & mMask);
+    }
+
+    void Set(const size_t x, const size_t y, const uint8_t value) {
+        if (x >= mWidth || y >= mHeight) {
+            return;
+        }
+
+        auto& word = mData[y * mStride + x / mCellsPerWord];
+        word = (word & ~(mMask << GetShift(x))) | (((Word)value & mMask) << GetShift(x));
+    }
+
+    // clipped to the row, partial words at the ends are masked, the ones in between are stored whole
+    void FillRow(const size_t x, const size_t y, const size_t count, const uint8_t value) {
+        if (y >= mHeight || x >= mWidth || !count) {
+            return;
+        }
+
+        const auto end = x + min(count, mWidth - x);
+        const auto pattern = Replicate(value);
+
+        auto* row = &mData[y * mStride];
+        const auto wordFirst = x / mCellsPerWord;
+        const auto wordLast = (end - 1) / mCellsPerWord;
+
+        const auto maskFirst = ~(Word)0 << GetShift(x);
+        const auto maskLast = ~(Word)0 >> (sizeof(Word) * 8 - GetShift(end - 1) - Bits);
+
+        if (wordFirst == wordLast) {
+            const auto mask = maskFirst & maskLast;
+            row[wordFirst] = (row[wordFirst] & ~mask) | (pattern & mask);
+            return;
+        }
+
+        row[wordFirst] = (row[wordFirst] & ~maskFirst) | (pattern & maskFirst);
+        fill(row + wordFirst + 1, row + wordLast, pattern);
+        row[wordLast] = (row[wordLast] & ~maskLast) | (pattern & maskLast);
+    }
+
+    template<typename T>
+    void Pack(const Matrix<T>& matrix) {
+        Resize(matrix.GetWidth(), matrix.GetHeight());
+
+        for (size_t y = 0; y < mHeight; y++) {
+            const auto* rowSource = matrix[y];
+            auto* row = GetRow(y);
+
+            for (size_t x = 0; x < mWidth; x++) {
+                row[x / mCellsPerWord] |= ((Word)rowSource[x] & mMask) << GetShift(x);
+            }
+        }
+    }
+
+    template<typename T>
+    void Unpack(Matrix<T>& matrix) const {
+        matrix.Resize(mWidth, mHeight);
+
+        for (size_t y = 0; y < mHeight; y++) {
+            auto* rowDestination = matrix[y];
+            const auto* row = GetRow(y);
+
+            for (size_t x = 0; x < mWidth; x++) {
+                rowDestination[x] = (T)((row[x / mCellsPerWord] >> GetShift(x)) & mMask);
+            }
+        }
+    }
+
+    Word* GetRow(const size_t y) {
+        return &mData[y * mStride];
+    }
+
+    const Word* GetRow(const size_t y) const {
+        return &mData[y * mStride];
+    }
+
+    Word* GetData() {
+        return mData.data();
+    }
+
+    const Word* GetData() const {
+        return mData.data();
+    }
+
+    size_t GetWidth() const {
+        return mWidth;
+    }
+
+    size_t GetHeight() const {
+        return mHeight;
+    }
+
+    // in words
+    size_t GetStride() const {
+        return mStride;
+    }
+
+    bool operator==(const MatrixPacked<Bits>& matrix) const {
+        if (mWidth != matrix.mWidth || mHeight != matrix.mHeight) {
+            return false;
+        }
+
+        for (size_t y = 0; y < mHeight; y++) {
+            for (size_t x = 0; x < mWidth; x++) {
+                if (Get(x, y) != matrix.Get(x, y)) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool operator!=(const MatrixPacked<Bits>& matrix) const {
+        return !(*this == matrix);
+    }
+
+private:
+    static constexpr size_t GetShift(const size_t x) {
+        return x % mCellsPerWord * Bits;
+    }
+
+    static constexpr Word Replicate(const uint8_t value) {
+        return (~(Word)0 / mMask) * ((Word)value & mMask);
+    }
+
+    vector<Word> mData {};
+    size_t mWidth {};
+    size_t mHeight {};
+    size_t mStride {};
+};
\ No newline at end of file
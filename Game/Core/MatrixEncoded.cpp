@@ -0,0 +1,2 @@
+#include "Game/pch.h"
+#include "MatrixEncoded.h"
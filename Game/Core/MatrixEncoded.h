@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Matrix.h"
+
+#include <cstdint>
+
+// Run-length encoded copy of a byte sized Matrix whose values fit in Bits. Every run is one
+// LEB128 varint holding the length minus one above the value, so short runs of small values
+// take a single byte, and an index of where the rows begin gives random access to single rows.
+// Only the runs need to be stored or sent, the index is rebuilt from them by Assign.
+template<typename T, size_t Bits = 8>
+class MatrixEncoded {
+public:
+    static_assert(sizeof(T) == 1 && is_trivially_copyable_v<T>, "MatrixEncoded only holds byte sized cells");
+    static_assert(Bits >= 1 && Bits <= 8, "Bits must be between 1 and 8");
+
+    MatrixEncoded() = default;
+
+    MatrixEncoded(const Matrix<T>& matrix) {
+        Encode(matrix);
+    }
+
+    void Encode(const Matrix<T>& matrix) {
+        mWidth = matrix.GetWidth();
+        mHeight = matrix.GetHeight();
+
+        mRuns.clear();
+        mRows.resize(mHeight + 1);
+
+        for (size_t y = 0; y < mHeight; y++) {
+            mRows[y] = mRuns.size();
+
+            const auto row = matrix[y];
+            for (size_t x = 0; x < mWidth;) {
+                const auto value = row[x];
+
+                auto length = (size_t)1;
+                while (x + length < mWidth && row[x + length] == value) {
+                    length++;
+                }
+
+                PushRun(value, length);
+                x += length;
+            }
+        }
+
+        mRows[mHeight] = mRuns.size();
+    }
+
+    // takes runs that came out of GetData and rebuilds the row index, false if they do not
+    // describe a width by height matrix, in which case the encoded matrix is left empty
+    bool Assign(const size_t width, const size_t height, const uint8_t* data, const size_t size) {
+        mWidth = width;
+        mHeight = height;
+        mRuns.assign(data, data + size);
+        mRows.resize(mHeight + 1);
+
+        size_t offset = 0;
+        for (size_t y = 0; y < mHeight; y++) {
+            mRows[y] = offset;
+
+            for (size_t x = 0; x < mWidth;) {
+                size_t run {};
+                if (!ReadRun(offset, run) || (run >> Bits) >= mWidth - x) {
+                    Clear();
+                    return false;
+                }
+
+                x += (run >> Bits) + 1;
+            }
+        }
+
+        mRows[mHeight] = offset;
+        if (offset != size) {
+            Clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    void Clear() {
+        mWidth = 0;
+        mHeight = 0;
+        mRuns.clear();
+        mRows.assign(1, 0);
+    }
+
+    // resizes matrix in place, so passing the same one again reuses its storage
+    void Decode(Matrix<T>& matrix) const {
+        matrix.Resize(mWidth, mHeight);
+
+        for (size_t y = 0; y < mHeight; y++) {
+            DecodeRow(y, matrix[y]);
+        }
+    }
+
+    // writes the width cells of row y starting at row
+    void DecodeRow(const size_t y, T* row) const {
+        for (auto offset = mRows[y]; offset < mRows[y + 1];) {
+            size_t run {};
+            ReadRun(offset, run);
+
+            const auto length = (run >> Bits) + 1;
+            memset(row, (int)(run & mMask), length);
+            row += length;
+        }
+    }
+
+    const uint8_t* GetData() const {
+        return mRuns.data();
+    }
+
+    // bytes taken by the runs, the index adds a size_t per row on top when held in memory
+    size_t GetSize() const {
+        return mRuns.size();
+    }
+
+    size_t GetRowSize(const size_t y) const {
+        return mRows[y + 1] - mRows[y];
+    }
+
+    size_t GetWidth() const {
+        return mWidth;
+    }
+
+    size_t GetHeight() const {
+        return mHeight;
+    }
+
+private:
+    static constexpr size_t mMask = ((size_t)1 << Bits) - 1;
+
+    void PushRun(const T& value, const size_t length) {
+        auto run = ((length - 1) << Bits) | ((size_t)value & mMask);
+
+        while (run >= 0x80) {
+            mRuns.push_back((uint8_t)(run | 0x80));
+            run >>= 7;
+        }
+
+        mRuns.push_back((uint8_t)run);
+    }
+
+    // advances offset past the varint, false if it runs off the end or overflows
+    bool ReadRun(size_t& offset, size_t& run) const {
+        run = 0;
+
+        for (size_t shift = 0; offset < mRuns.size() && shift < sizeof(size_t) * 8; shift += 7) {
+            const auto byte = mRuns[offset++];
+            run |= (size_t)(byte & 0x7F) << shift;
+
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    size_t mWidth {};
+    size_t mHeight {};
+
+    vector<uint8_t> mRuns {};
+    vector<size_t> mRows { 0 };
+};
\ No newline at end of file
@@ -145,6 +145,43 @@ public:
         mH = h;
     }
 
+    bool operator==(const Rectangle<T>& rectangle) const {
+        return mX == rectangle.mX && mY == rectangle.mY && mW == rectangle.mW && mH == rectangle.mH;
+    }
+
+    bool operator!=(const Rectangle<T>& rectangle) const {
+        return !(*this == rectangle);
+    }
+
+    // half-open, so a point on the edge two neighbours share belongs to only one of them
+    bool Contains(const Point<T>& point) const {
+        return point.GetX() >= mX && point.GetX() < mX + mW &&
+               point.GetY() >= mY && point.GetY() < mY + mH;
+    }
+
+    bool Intersects(const Rectangle<T>& rectangle) const {
+        return mX < rectangle.mX + rectangle.mW && rectangle.mX < mX + mW &&
+               mY < rectangle.mY + rectangle.mH && rectangle.mY < mY + mH;
+    }
+
+    // the smallest rectangle covering both
+    Rectangle<T> Merge(const Rectangle<T>& rectangle) const {
+        const auto x = min(mX, rectangle.mX);
+        const auto y = min(mY, rectangle.mY);
+
+        return { x, y,
+                 max(mX + mW, rectangle.mX + rectangle.mW) - x,
+                 max(mY + mH, rectangle.mY + rectangle.mH) - y };
+    }
+
+    // 0 for points inside
+    T GetDistanceSquared(const Point<T>& point) const {
+        const auto dx = max({ mX - point.GetX(), (T)0, point.GetX() - (mX + mW) });
+        const auto dy = max({ mY - point.GetY(), (T)0, point.GetY() - (mY + mH) });
+
+        return dx * dx + dy * dy;
+    }
+
 private:
     T mX {};
     T mY {};
@@ -157,48 +194,102 @@ class NodeTreeBinary {
 public:
     NodeTreeBinary() = default;
 
-    NodeTreeBinary(const T& leaf) : mLeaf(leaf) {}
+    NodeTreeBinary(const T& leaf) : mLeaf(leaf), mIsUsed(true) {}
 
-    void GetLeafs(list<NodeTreeBinary<T>>& nodes) const {
-        if (!mLeft && !mRight) {
-            nodes.push_back(mLeaf);
-        } else {
-            if (mLeft) {
-                mLeft->GetLeafs(nodes);
-            }
+    const T& GetLeaf() const {
+        return mLeaf;
+    }
 
-            if (mRight) {
-                mRight->GetLeafs(nodes);
-            }
-        }
+    bool IsUsed() const {
+        return mIsUsed;
     }
 
-    const T& GetLeaf() const {
-        return mLeaf;
+    void SetLeaf(const T& leaf) {
+        mLeaf = leaf;
+        mIsUsed = true;
     }
 
-    NodeTreeBinary<T>* const GetLeft() const {
-        return mLeft;
+private:
+    T mLeaf {};
+    bool mIsUsed = false;
+};
+
+// Complete binary tree stored in heap order inside one contiguous buffer:
+// the children of the node at index i live at 2i + 1 and 2i + 2,
+// so walking it never chases pointers and freeing it is a single deallocation.
+template<typename T>
+class TreeBinary {
+public:
+    TreeBinary() = default;
+
+    TreeBinary(const size_t depth) {
+        Reset(depth);
     }
 
-    NodeTreeBinary<T>* const GetRight() const {
-        return mRight;
+    static constexpr size_t GetSize(const size_t depth) {
+        return ((size_t)2 << depth) - 1;
     }
 
-    void SetLeaf(const T& leaf) {
-        mLeaf = leaf;
+    static constexpr size_t GetLevelFirst(const size_t depth) {
+        return ((size_t)1 << depth) - 1;
+    }
+
+    static constexpr size_t GetLeft(const size_t index) {
+        return index * 2 + 1;
+    }
+
+    static constexpr size_t GetRight(const size_t index) {
+        return index * 2 + 2;
+    }
+
+    static constexpr size_t GetParent(const size_t index) {
+        return (index - 1) / 2;
+    }
+
+    // index of the first node found `levels` levels below the node at index
+    static constexpr size_t GetDescendantFirst(const size_t index, const size_t levels) {
+        return ((index + 1) << levels) - 1;
+    }
+
+    void Reset(const size_t depth) {
+        mNodes = vector<NodeTreeBinary<T>>(GetSize(depth));
+        mDepth = depth;
     }
 
-    void SetLeft(NodeTreeBinary<T>* const left) {
-        mLeft = left;
+    void Clear() {
+        mNodes = {};
+        mDepth = 0;
     }
 
-    void SetRight(NodeTreeBinary<T>* const right) {
-        mRight = right;
+    bool IsParent(const size_t index) const {
+        return index < GetLevelFirst(mDepth) && mNodes[GetLeft(index)].IsUsed();
+    }
+
+    bool IsLeaf(const size_t index) const {
+        return mNodes[index].IsUsed() && !IsParent(index);
+    }
+
+    size_t GetDepth() const {
+        return mDepth;
+    }
+
+    size_t GetSize() const {
+        return mNodes.size();
+    }
+
+    bool IsEmpty() const {
+        return mNodes.empty();
+    }
+
+    NodeTreeBinary<T>& operator[](const size_t index) {
+        return mNodes[index];
+    }
+
+    const NodeTreeBinary<T>& operator[](const size_t index) const {
+        return mNodes[index];
     }
 
 private:
-    T mLeaf {};
-    NodeTreeBinary<T>* mLeft = nullptr;
-    NodeTreeBinary<T>* mRight = nullptr;
+    vector<NodeTreeBinary<T>> mNodes {};
+    size_t mDepth {};
 };
\ No newline at end of file
@@ -1,18 +1,20 @@
 #include "Game/pch.h"
+#include "Engine/Utility/Profiler.h"
+#include "Engine/Utility/ThreadPool.h"
+#include "Rasterizer.h"
 #include "Dungeon.h"
 
-float RandomFloat(const float min, const float max) {
-    static Random random {};
+float RandomFloat(RandomCounter& random, const float min, const float max) {
     return floor(random.GetReal(0.f, 1.f) * (max - min + 1.f) + min);
 }
 
-Room::Room(const Rectangle<float>& rectangle) {
-    mRectangle.SetX(rectangle.GetX() + RandomFloat(0.f, floor(rectangle.GetW() / 3.f)));
-    mRectangle.SetY(rectangle.GetY() + RandomFloat(0.f, floor(rectangle.GetH() / 3.f)));
+Room::Room(const Rectangle<float>& rectangle, RandomCounter& random) {
+    mRectangle.SetX(rectangle.GetX() + RandomFloat(random, 0.f, floor(rectangle.GetW() / 3.f)));
+    mRectangle.SetY(rectangle.GetY() + RandomFloat(random, 0.f, floor(rectangle.GetH() / 3.f)));
     mRectangle.SetW(rectangle.GetW() - (mRectangle.GetX() - rectangle.GetX()));
     mRectangle.SetH(rectangle.GetH() - (mRectangle.GetY() - rectangle.GetY()));
-    mRectangle.SetW(mRectangle.GetW() - RandomFloat(0.f, mRectangle.GetW() / 3.f));
-    mRectangle.SetH(mRectangle.GetH() - RandomFloat(0.f, mRectangle.GetH() / 3.f));
+    mRectangle.SetW(mRectangle.GetW() - RandomFloat(random, 0.f, mRectangle.GetW() / 3.f));
+    mRectangle.SetH(mRectangle.GetH() - RandomFloat(random, 0.f, mRectangle.GetH() / 3.f));
 }
 
 const Rectangle<float>& Room::GetRectangle() const {
@@ -74,226 +76,458 @@ Dungeon::Dungeon(
     const size_t iterations,
     const Point<float>& size,
     const float tileSize /* = 5.f */,
-    const Point<float>& ratioToDiscard /* = { 0.45f, 0.45f } */
+    const Point<float>& ratioToDiscard /* = { 0.45f, 0.45f } */,
+    const uint64_t seed /* = random_device {}() */,
+    const size_t threads /* = 1 */,
+    const size_t depthParallel /* = 4 */
 ) :
     mCanvas(0.f, 0.f, size.GetX(), size.GetY()),
-    mTileSize(tileSize),
     mRatioToDiscard(ratioToDiscard),
-    mTree(SplitRectangle(mCanvas, iterations)) {
+    mSeed(seed),
+    mTileSize(tileSize) {
 
-    GenerateRooms();
-    GeneratePaths(mTree, mPaths);
+    SplitRectangle(mCanvas, iterations, threads, depthParallel);
 }
 
-void Dungeon::GenerateTileMatrix(vector<vector<Tile>>& tileMatrix) {
-    tileMatrix = vector<vector<Tile>>((size_t)(mCanvas.GetH() / mTileSize), vector<Tile>((size_t)(mCanvas.GetW() / mTileSize), Tile::NONE));
+void Dungeon::GenerateTileMatrix(Matrix<Tile>& tileMatrix, const size_t threads /* = 1 */) const {
+    PROFILE_SCOPE("Dungeon::GenerateTileMatrix");
 
-    for (const auto& path : mPaths) {
-        if (path.GetRectangle().GetW() == mTileSize) {
-            const auto start = (size_t)(path.GetRectangle().GetY() / mTileSize);
-            const auto length = (size_t)(path.GetRectangle().GetH() / mTileSize);
-            const auto width = (size_t)(path.GetRectangle().GetX() / mTileSize);
+    tileMatrix.Resize(GetTileMatrixWidth(), GetTileMatrixHeight(), Tile::NONE);
 
-            for (size_t i = 0; i < length; i++) {
-                tileMatrix[start + i][width] = Tile::PATH;
-            }
-        } else {
-            const auto start = (size_t)(path.GetRectangle().GetX() / mTileSize);
-            const auto length = (size_t)(path.GetRectangle().GetW() / mTileSize);
-            const auto height = (size_t)(path.GetRectangle().GetY() / mTileSize);
+    auto& rasterizer = GetRasterizer(threads);
+    AddTiles(rasterizer);
 
-            for (size_t i = 0; i < length; i++) {
-                tileMatrix[height][start + i] = Tile::PATH;
-            }
-        }
-    }
+    const Tile values[] = { Tile::PATH, Tile::ROOM };
+    rasterizer.Rasterize(tileMatrix, values);
+}
 
-    for (const auto& room : mRooms) {
-        const auto offsetX = (size_t)(room.GetRectangle().GetX() / mTileSize);
-        const auto offsetY = (size_t)(room.GetRectangle().GetY() / mTileSize);
-        const auto width = (size_t)(room.GetRectangle().GetW() / mTileSize);
-        const auto height = (size_t)(room.GetRectangle().GetH() / mTileSize);
-
-        for (size_t i = 0; i < height; i++) {
-            for (size_t j = 0; j < width; j++) {
-                tileMatrix[offsetY + i][offsetX + j] = Tile::ROOM;
-            }
-        }
-    }
+void Dungeon::GenerateTileMatrix(MatrixPacked<2>& tileMatrix, const size_t threads /* = 1 */) const {
+    PROFILE_SCOPE("Dungeon::GenerateTileMatrix");
+
+    tileMatrix.Resize(GetTileMatrixWidth(), GetTileMatrixHeight(), (uint8_t)Tile::NONE);
+
+    auto& rasterizer = GetRasterizer(threads);
+    AddTiles(rasterizer);
+
+    const uint8_t values[] = { (uint8_t)Tile::PATH, (uint8_t)Tile::ROOM };
+    rasterizer.Rasterize(tileMatrix, values);
 }
 
-void Dungeon::Render(
-    SDL_Renderer* renderer,
-    const Point<float>& scale /* = { 1.f, 1.f } */,
-    const Point<float>& offset /* = {} */
-) {
-    SDL_FPoint scaleLast {};
-    SDL_RenderGetScale(renderer, &scaleLast.x, &scaleLast.y);
+void Dungeon::GenerateTilePlane(const Tile tile, MatrixPacked<1>& tilePlane, const size_t threads /* = 1 */) const {
+    PROFILE_SCOPE("Dungeon::GenerateTilePlane");
 
-    SDL_RenderSetScale(renderer, scale.GetX(), scale.GetY());
+    tilePlane.Resize(GetTileMatrixWidth(), GetTileMatrixHeight(), 0);
 
-    //RenderTree(renderer, mTree, offset);
-    RenderPaths(renderer, offset);
-    RenderRooms(renderer, offset);
+    auto& rasterizer = GetRasterizer(threads);
+    AddTiles(rasterizer);
 
-    SDL_RenderSetScale(renderer, scaleLast.x, scaleLast.y);
+    const uint8_t values[] = { (uint8_t)(tile == Tile::PATH), (uint8_t)(tile == Tile::ROOM) };
+    rasterizer.Rasterize(tilePlane, values);
 }
 
-Dungeon::~Dungeon() {
-    DeleteTree(mTree);
-    mTree = nullptr;
+size_t Dungeon::GetTileMatrixWidth() const {
+    return (size_t)(mCanvas.GetW() / mTileSize);
 }
 
-void Dungeon::RenderRoom(
-    SDL_Renderer* renderer,
-    const Room& room,
-    const Point<float>& offset /* = {} */
-) const {
-    SDL_FRect frect { room.GetRectangle().GetX(), room.GetRectangle().GetY(),
-                      room.GetRectangle().GetW(), room.GetRectangle().GetH() };
-    AddOffset(frect, offset);
+size_t Dungeon::GetTileMatrixHeight() const {
+    return (size_t)(mCanvas.GetH() / mTileSize);
+}
 
-    SDL_RenderFillRectF(renderer, &frect);
+const Rectangle<float>& Dungeon::GetCanvas() const {
+    return mCanvas;
 }
 
-void Dungeon::RenderRooms(SDL_Renderer* renderer, const Point<float>& offset /* = {} */) const {
-    for (const auto& room : mRooms) {
-        RenderRoom(renderer, room, offset);
+const vector<Room>& Dungeon::GetRooms() const {
+    return mRooms;
+}
+
+const vector<Path>& Dungeon::GetPaths() const {
+    return mPaths;
+}
+
+float Dungeon::GetTileSize() const {
+    return mTileSize;
+}
+
+uint64_t Dungeon::GetSeed() const {
+    return mSeed;
+}
+
+const TreeBinary<Rectangle<float>>& Dungeon::GetTree() const {
+    return mTree;
+}
+
+size_t Dungeon::GetRoomAt(const Point<float>& point) const {
+    return FindAt(point, true);
+}
+
+size_t Dungeon::GetPathAt(const Point<float>& point) const {
+    return FindAt(point, false);
+}
+
+void Dungeon::GetRoomsAt(const Point<float>* points, const size_t count, size_t* rooms) const {
+    for (size_t i = 0; i < count; i++) {
+        rooms[i] = FindAt(points[i], true);
     }
 }
 
-void Dungeon::RenderPath(
-    SDL_Renderer* renderer,
-    const Path& path,
-    const Point<float>& offset /* = {} */
-) const {
-    SDL_FRect frect { path.GetRectangle().GetX(), path.GetRectangle().GetY(),
-                      path.GetRectangle().GetW(), path.GetRectangle().GetH() };
-    AddOffset(frect, offset);
+void Dungeon::GetPathsAt(const Point<float>* points, const size_t count, size_t* paths) const {
+    for (size_t i = 0; i < count; i++) {
+        paths[i] = FindAt(points[i], false);
+    }
+}
 
-    SDL_RenderFillRectF(renderer, &frect);
+void Dungeon::GetRoomsIn(const Rectangle<float>& area, vector<size_t>& rooms) const {
+    FindIn(area, true, rooms);
 }
 
-void Dungeon::RenderPaths(
-    SDL_Renderer* renderer,
-    const Point<float>& offset /* = {} */
-) {
-    for (auto& path : mPaths) {
-        RenderPath(renderer, path, offset);
+void Dungeon::GetPathsIn(const Rectangle<float>& area, vector<size_t>& paths) const {
+    FindIn(area, false, paths);
+}
+
+void Dungeon::GetRoomsNearest(const Point<float>& point, const size_t count, vector<size_t>& rooms) const {
+    rooms.clear();
+    if (!count || mTree.IsEmpty() || !mTree[0].IsUsed()) {
+        return;
+    }
+
+    // best first: the bounds of a node are never farther than anything under it, and the bounds
+    // of a leaf are its room, so the leaves come off the queue nearest first
+    using Entry = pair<float, size_t>;
+    priority_queue<Entry, vector<Entry>, greater<Entry>> queue {};
+    queue.push({ mBounds[0].GetDistanceSquared(point), 0 });
+
+    while (!queue.empty() && rooms.size() < count) {
+        const auto index = queue.top().second;
+        queue.pop();
+
+        if (mTree.IsLeaf(index)) {
+            rooms.push_back(mItems[index]);
+            continue;
+        }
+
+        const auto left = TreeBinary<Rectangle<float>>::GetLeft(index);
+        const auto right = TreeBinary<Rectangle<float>>::GetRight(index);
+        queue.push({ mBounds[left].GetDistanceSquared(point), left });
+        queue.push({ mBounds[right].GetDistanceSquared(point), right });
     }
 }
 
-void Dungeon::RenderRectangle(
-    SDL_Renderer* renderer,
+bool Dungeon::SplitRandom(
     const Rectangle<float>& rectangle,
-    const Point<float>& offset /* = {} */
+    RandomCounter& random,
+    pair<Rectangle<float>, Rectangle<float>>& rectangles
 ) const {
-    SDL_FRect frect { rectangle.GetX(), rectangle.GetY(),
-                      rectangle.GetW(), rectangle.GetH() };
-    AddOffset(frect, offset);
+    pair<float, float> rangeW {}, rangeH {};
+    const auto canSplitW = GetCutRange(rectangle.GetW(), rectangle.GetH(), mRatioToDiscard.GetX(), rangeW);
+    const auto canSplitH = GetCutRange(rectangle.GetH(), rectangle.GetW(), mRatioToDiscard.GetY(), rangeH);
+
+    if (!canSplitW && !canSplitH) {
+        return false;
+    }
+
+    // the axis is only left to chance when both of them can be cut
+    const auto splitW = canSplitW && (!canSplitH || RandomFloat(random, 0.f, 1.f));
+
+    if (splitW) {
+        const auto w = min(RandomFloat(random, rangeW.first, rangeW.second), rangeW.second);
+
+        rectangles = { Rectangle<float>(rectangle.GetX(), rectangle.GetY(), w, rectangle.GetH()),
+                       Rectangle<float>(rectangle.GetX() + w, rectangle.GetY(), rectangle.GetW() - w, rectangle.GetH()) };
+    } else {
+        const auto h = min(RandomFloat(random, rangeH.first, rangeH.second), rangeH.second);
+
+        rectangles = { Rectangle<float>(rectangle.GetX(), rectangle.GetY(), rectangle.GetW(), h),
+                       Rectangle<float>(rectangle.GetX(), rectangle.GetY() + h, rectangle.GetW(), rectangle.GetH() - h) };
+    }
 
-    SDL_RenderDrawRectF(renderer, &frect);
+    return true;
 }
 
-void Dungeon::RenderTree(
-    SDL_Renderer* renderer,
-    NodeTreeBinary<Rectangle<float>>* const tree,
-    const Point<float>& offset /* = {} */
-) const {
-    RenderRectangle(renderer, tree->GetLeaf(), offset);
+bool Dungeon::GetCutRange(const float length, const float breadth, const float ratio, pair<float, float>& range) const {
+    // both halves must keep length / breadth >= ratio and at least one unit of length
+    auto first = max(1.f, ceil(ratio * breadth));
+    auto last = min(ceil(length) - 1.f, floor(length - ratio * breadth));
 
-    if (tree->GetLeft()) {
-        RenderTree(renderer, tree->GetLeft());
+    // the products above may round either way, so settle the bounds with the very comparisons
+    // the halves are expected to pass
+    while (first <= last && first / breadth < ratio) {
+        first++;
     }
 
-    if (tree->GetRight()) {
-        RenderTree(renderer, tree->GetRight());
+    while (first <= last && (length - last) / breadth < ratio) {
+        last--;
     }
+
+    range = { first, last };
+    return first <= last;
 }
 
-pair<Rectangle<float>, Rectangle<float>> Dungeon::SplitRandom(const Rectangle<float>& rectangle) const {
-    Rectangle<float> rectOne, rectTwo;
+void Dungeon::SplitRectangle(
+    const Rectangle<float>& container,
+    const size_t iterations,
+    const size_t threads,
+    const size_t depthParallel
+) {
+    PROFILE_SCOPE("Dungeon::SplitRectangle");
+
+    mTree.Reset(iterations);
+    mTree[0].SetLeaf(container);
+
+    const RandomCounter random(mSeed);
+
+    // the top of the tree goes first, so the subtrees below it can be split independently
+    const auto depth = min(depthParallel, iterations);
+    const auto subtreeCount = (size_t)1 << depth;
+    const auto subtreeFirst = TreeBinary<Rectangle<float>>::GetLevelFirst(depth);
+
+    vector<Subtree> subtrees(subtreeCount + 1);
+    GenerateSubtree(0, 0, depth, random, subtrees[0]);
+
+    const auto generate = [&](const size_t subtree) {
+        const auto root = subtreeFirst + subtree;
+        GenerateSubtree(root, depth, iterations - depth + 1, random, subtrees[subtree + 1]);
+    };
 
-    if (RandomFloat(0.f, 1.f)) {
-        rectOne = Rectangle<float>(rectangle.GetX(), rectangle.GetY(),
-                                   RandomFloat(1.f, rectangle.GetW()), rectangle.GetH());
-        rectTwo = Rectangle<float>(rectangle.GetX() + rectOne.GetW(), rectangle.GetY(),
-                                   rectangle.GetW() - rectOne.GetW(), rectangle.GetH());
+    if (threads > 1 && subtreeCount > 1) {
+        ThreadPool threadPool(min(threads, subtreeCount) - 1);
+        threadPool.ForEach(subtreeCount, generate);
+    } else {
+        for (size_t i = 0; i < subtreeCount; i++) {
+            generate(i);
+        }
+    }
 
-        if (mRatioToDiscard != Point(0.f, 0.f)) {
-            const auto rectOneRatioW = rectOne.GetW() / rectOne.GetH();
-            const auto rectTwoRatioW = rectTwo.GetW() / rectTwo.GetH();
+    MergeSubtrees(subtrees);
+
+    BuildIndex();
+}
 
-            if (rectOneRatioW < mRatioToDiscard.GetX() ||
-                rectTwoRatioW < mRatioToDiscard.GetX()) {
-                return SplitRandom(rectangle);
+void Dungeon::GenerateSubtree(
+    const size_t root,
+    const size_t depth,
+    const size_t levels,
+    const RandomCounter& random,
+    Subtree& subtree
+) {
+    {
+        PROFILE_SCOPE("Dungeon::Split");
+
+        // the subtree is filled level by level, so every parent is split before its children are visited
+        for (size_t level = 0; level < levels && depth + level < mTree.GetDepth(); level++) {
+            const auto first = TreeBinary<Rectangle<float>>::GetDescendantFirst(root, level);
+            const auto last = first + ((size_t)1 << level);
+
+            for (size_t i = first; i < last; i++) {
+                auto randomNode = random.Split(i);
+                SplitNode(i, randomNode);
             }
         }
-    } else {
-        rectOne = Rectangle<float>(rectangle.GetX(), rectangle.GetY(),
-                                   rectangle.GetW(), RandomFloat(1.f, rectangle.GetH()));
-        rectTwo = Rectangle<float>(rectangle.GetX(), rectangle.GetY() + rectOne.GetH(),
-                                   rectangle.GetW(), rectangle.GetH() - rectOne.GetH());
-
-        if (mRatioToDiscard != Point(0.f, 0.f)) {
-            const auto rectOneRatioH = rectOne.GetH() / rectOne.GetW();
-            const auto rectTwoRatioH = rectTwo.GetH() / rectTwo.GetW();
-
-            if (rectOneRatioH < mRatioToDiscard.GetY() ||
-                rectTwoRatioH < mRatioToDiscard.GetY()) {
-                return SplitRandom(rectangle);
+    }
+
+    {
+        PROFILE_SCOPE("Dungeon::Rooms");
+
+        for (size_t level = 0; level < levels; level++) {
+            const auto first = TreeBinary<Rectangle<float>>::GetDescendantFirst(root, level);
+            const auto last = first + ((size_t)1 << level);
+
+            for (size_t i = first; i < last; i++) {
+                if (mTree.IsLeaf(i)) {
+                    // a leaf never split, so its stream is still untouched
+                    auto randomNode = random.Split(i);
+                    subtree.rooms.push_back(GenerateRoom(i, randomNode));
+                    subtree.roomNodes.push_back((uint32_t)i);
+                }
             }
         }
     }
 
-    return { rectOne, rectTwo };
+    {
+        PROFILE_SCOPE("Dungeon::Paths");
+
+        for (size_t level = 0; level < levels; level++) {
+            const auto first = TreeBinary<Rectangle<float>>::GetDescendantFirst(root, level);
+            const auto last = first + ((size_t)1 << level);
+
+            for (size_t i = first; i < last; i++) {
+                if (mTree.IsParent(i)) {
+                    subtree.paths.push_back(GeneratePath(i));
+                    subtree.pathNodes.push_back((uint32_t)i);
+                }
+            }
+        }
+    }
 }
 
-NodeTreeBinary<Rectangle<float>>* Dungeon::SplitRectangle(const Rectangle<float>& container, const size_t iterations) const {
-    NodeTreeBinary<Rectangle<float>>* root = new NodeTreeBinary<Rectangle<float>>(container);
-    if (iterations) {
-        const auto pair = SplitRandom(container);
+void Dungeon::MergeSubtrees(const vector<Subtree>& subtrees) {
+    PROFILE_SCOPE("Dungeon::MergeSubtrees");
 
-        root->SetLeft(SplitRectangle(pair.first, iterations - 1));
-        root->SetRight(SplitRectangle(pair.second, iterations - 1));
+    mRooms.clear();
+    mPaths.clear();
+
+    // every used node holds exactly one item: a room if it is a leaf, a path if it is a parent
+    mItems.assign(mTree.GetSize(), numeric_limits<uint32_t>::max());
+
+    size_t roomsCount = 0, pathsCount = 0;
+    for (const auto& subtree : subtrees) {
+        roomsCount += subtree.rooms.size();
+        pathsCount += subtree.paths.size();
     }
 
-    return root;
+    mRooms.reserve(roomsCount);
+    mPaths.reserve(pathsCount);
+    for (const auto& subtree : subtrees) {
+        for (size_t i = 0; i < subtree.roomNodes.size(); i++) {
+            mItems[subtree.roomNodes[i]] = (uint32_t)(mRooms.size() + i);
+        }
+
+        for (size_t i = 0; i < subtree.pathNodes.size(); i++) {
+            mItems[subtree.pathNodes[i]] = (uint32_t)(mPaths.size() + i);
+        }
+
+        mRooms.insert(mRooms.end(), subtree.rooms.begin(), subtree.rooms.end());
+        mPaths.insert(mPaths.end(), subtree.paths.begin(), subtree.paths.end());
+    }
+}
+
+void Dungeon::BuildIndex() {
+    PROFILE_SCOPE("Dungeon::BuildIndex");
+
+    mBounds.assign(mTree.GetSize(), {});
+
+    // children sit after their parents, so walking backwards finishes them first; paths are
+    // aligned to the tiles and may stick out of their node, hence the union instead of the node
+    for (size_t i = mTree.GetSize(); i-- > 0;) {
+        if (mTree.IsLeaf(i)) {
+            mBounds[i] = mRooms[mItems[i]].GetRectangle();
+        } else if (mTree.IsParent(i)) {
+            mBounds[i] = mPaths[mItems[i]].GetRectangle()
+                             .Merge(mBounds[TreeBinary<Rectangle<float>>::GetLeft(i)])
+                             .Merge(mBounds[TreeBinary<Rectangle<float>>::GetRight(i)]);
+        }
+    }
 }
 
-void Dungeon::GenerateRooms() {
-    list<NodeTreeBinary<Rectangle<float>>> leafs;
-    mTree->GetLeafs(leafs);
-    for (const auto& leaf : leafs) {
-        Rectangle<float> room(leaf.GetLeaf());
+size_t Dungeon::FindAt(const Point<float>& point, const bool isRoom) const {
+    size_t found = mNone;
 
-        const auto trimLeft = fmod(room.GetX(), mTileSize);
-        if (trimLeft) {
-            room.SetX(room.GetX() + (mTileSize - trimLeft));
+    Walk([&](const size_t index) {
+        if (!mBounds[index].Contains(point)) {
+            return false;
         }
 
-        const auto trimRight = fmod(room.GetW(), mTileSize);
-        room.SetW(room.GetW() - trimRight);
+        if (mTree.IsLeaf(index) == isRoom && GetItem(index, isRoom).Contains(point)) {
+            found = mItems[index];
+        }
+
+        return found == mNone;
+    });
+
+    return found;
+}
+
+void Dungeon::FindIn(const Rectangle<float>& area, const bool isRoom, vector<size_t>& items) const {
+    Walk([&](const size_t index) {
+        if (!mBounds[index].Intersects(area)) {
+            return false;
+        }
 
-        const auto trimTop = fmod(room.GetY(), mTileSize);
-        if (trimTop) {
-            room.SetY(room.GetY() + (mTileSize - trimTop));
+        if (mTree.IsLeaf(index) == isRoom && GetItem(index, isRoom).Intersects(area)) {
+            items.push_back(mItems[index]);
         }
 
-        const auto trimBottom = fmod(room.GetH(), mTileSize);
-        room.SetH(room.GetH() - trimBottom);
+        return true;
+    });
+}
 
-        mRooms.push_back(room);
-    }
+const Rectangle<float>& Dungeon::GetItem(const size_t index, const bool isRoom) const {
+    return isRoom ? mRooms[mItems[index]].GetRectangle() : mPaths[mItems[index]].GetRectangle();
 }
 
-void Dungeon::GeneratePaths(NodeTreeBinary<Rectangle<float>>* const tree, list<Path>& paths) {
-    if (!tree->GetLeft() || !tree->GetRight()) {
+void Dungeon::SplitNode(const size_t index, RandomCounter& random) {
+    if (!mTree[index].IsUsed()) {
         return;
     }
 
-    Path path(tree->GetLeft()->GetLeaf(), tree->GetRight()->GetLeaf(), mTileSize);
+    // a node too narrow to be cut on either axis simply stays a leaf
+    pair<Rectangle<float>, Rectangle<float>> rectangles {};
+    if (!SplitRandom(mTree[index].GetLeaf(), random, rectangles)) {
+        return;
+    }
+
+    mTree[TreeBinary<Rectangle<float>>::GetLeft(index)].SetLeaf(rectangles.first);
+    mTree[TreeBinary<Rectangle<float>>::GetRight(index)].SetLeaf(rectangles.second);
+}
+
+Room Dungeon::GenerateRoom(const size_t index, RandomCounter& random) const {
+    Rectangle<float> room(mTree[index].GetLeaf());
+
+    const auto trimLeft = fmod(room.GetX(), mTileSize);
+    if (trimLeft) {
+        room.SetX(room.GetX() + (mTileSize - trimLeft));
+    }
+
+    const auto trimRight = fmod(room.GetW(), mTileSize);
+    room.SetW(room.GetW() - trimRight);
+
+    const auto trimTop = fmod(room.GetY(), mTileSize);
+    if (trimTop) {
+        room.SetY(room.GetY() + (mTileSize - trimTop));
+    }
+
+    const auto trimBottom = fmod(room.GetH(), mTileSize);
+    room.SetH(room.GetH() - trimBottom);
+
+    return { room, random };
+}
+
+Path Dungeon::GeneratePath(const size_t index) const {
+    Path path(mTree[TreeBinary<Rectangle<float>>::GetLeft(index)].GetLeaf(),
+              mTree[TreeBinary<Rectangle<float>>::GetRight(index)].GetLeaf(),
+              mTileSize);
+    AlignPath(path);
+
+    return path;
+}
+
+void Dungeon::AddTiles(Rasterizer& rasterizer) const {
+    rasterizer.Clear();
+    rasterizer.Reserve(mPaths.size() + mRooms.size());
+
+    // rooms go last so they cover the ends of the paths leading into them
+    for (const auto& path : mPaths) {
+        const auto x = (size_t)(path.GetRectangle().GetX() / mTileSize);
+        const auto y = (size_t)(path.GetRectangle().GetY() / mTileSize);
+
+        if (path.GetRectangle().GetW() == mTileSize) {
+            rasterizer.Add(x, y, 1, (size_t)(path.GetRectangle().GetH() / mTileSize), 0);
+        } else {
+            rasterizer.Add(x, y, (size_t)(path.GetRectangle().GetW() / mTileSize), 1, 0);
+        }
+    }
+
+    for (const auto& room : mRooms) {
+        rasterizer.Add((size_t)(room.GetRectangle().GetX() / mTileSize),
+                       (size_t)(room.GetRectangle().GetY() / mTileSize),
+                       (size_t)(room.GetRectangle().GetW() / mTileSize),
+                       (size_t)(room.GetRectangle().GetH() / mTileSize),
+                       1);
+    }
+}
 
+Rasterizer& Dungeon::GetRasterizer(const size_t threads) {
+    // one per calling thread, so concurrent callers never share it while its shapes
+    // and workers stay alive from one tile matrix to the next
+    thread_local unique_ptr<Rasterizer> rasterizer {};
+    if (!rasterizer || rasterizer->GetThreads() != threads) {
+        rasterizer = make_unique<Rasterizer>(threads);
+    }
+
+    return *rasterizer;
+}
+
+void Dungeon::AlignPath(Path& path) const {
     const auto offsetX = fmod(path.GetRectangle().GetX(), mTileSize);
     if (offsetX > 5.f) {
         path.AddOffset({ mTileSize - offsetX, 0.f });
@@ -323,25 +557,4 @@ void Dungeon::GeneratePaths(NodeTreeBinary<Rectangle<float>>* const tree, list<P
             path.AddSize({ 0.f, -trimH });
         }
     }
-
-    paths.push_back(path);
-
-    GeneratePaths(tree->GetLeft(), paths);
-    GeneratePaths(tree->GetRight(), paths);
-}
-
-void Dungeon::DeleteTree(NodeTreeBinary<Rectangle<float>>* tree) {
-    if (!tree) {
-        return;
-    }
-
-    DeleteTree(tree->GetLeft());
-    DeleteTree(tree->GetRight());
-
-    delete tree;
-}
-
-void Dungeon::AddOffset(SDL_FRect& rect, const Point<float>& offset) const {
-    rect.x += offset.GetX();
-    rect.y += offset.GetY();
 }
\ No newline at end of file
@@ -1,10 +1,15 @@
 #pragma once
 
 #include "Game/Core/Types.h"
+#include "Game/Core/Matrix.h"
+
+#include "Engine/Utility/Random.h"
+
+class Rasterizer;
 
 class Room {
 public:
-    Room(const Rectangle<float>& rectangle);
+    Room(const Rectangle<float>& rectangle, RandomCounter& random);
 
     const Rectangle<float>& GetRectangle() const;
 
@@ -37,73 +42,165 @@ public:
         PATH
     };
 
+    // what the queries below return when nothing matches
+    static constexpr size_t mNone = numeric_limits<size_t>::max();
+
+    // Every node draws from its own random stream split off the seed by the node's index,
+    // so the result depends only on the seed and never on how many threads generated the
+    // subtrees found at depthParallel
     Dungeon(
         const size_t iterations,
         const Point<float>& size,
         const float tileSize = 5.f,
-        const Point<float>& ratioToDiscard = { 0.45f, 0.45f }
+        const Point<float>& ratioToDiscard = { 0.45f, 0.45f },
+        const uint64_t seed = random_device {}(),
+        const size_t threads = 1,
+        const size_t depthParallel = 4
     );
 
-    void GenerateTileMatrix(vector<vector<Tile>>& tileMatrix);
+    // The tile matrices are resized in place, so passing the same one again reuses its storage
 
-    void Render(
-        SDL_Renderer* renderer,
-        const Point<float>& scale = { 1.f, 1.f },
-        const Point<float>& offset = {}
-    );
+    void GenerateTileMatrix(Matrix<Tile>& tileMatrix, const size_t threads = 1) const;
+
+    void GenerateTileMatrix(MatrixPacked<2>& tileMatrix, const size_t threads = 1) const;
+
+    // 1 where the tile matrix holds tile, 0 everywhere else
+    void GenerateTilePlane(const Tile tile, MatrixPacked<1>& tilePlane, const size_t threads = 1) const;
+
+    size_t GetTileMatrixWidth() const;
+
+    size_t GetTileMatrixHeight() const;
+
+    const Rectangle<float>& GetCanvas() const;
+
+    const vector<Room>& GetRooms() const;
+
+    const vector<Path>& GetPaths() const;
+
+    float GetTileSize() const;
+
+    uint64_t GetSeed() const;
+
+    const TreeBinary<Rectangle<float>>& GetTree() const;
+
+    // The queries below use the BSP tree as an index: every node knows the bounds of the rooms
+    // and paths under it, so a query only walks down the subtrees it can hit. They never change
+    // the dungeon, so any number of threads may run them at once.
+
+    // index of the room holding point, or mNone
+    size_t GetRoomAt(const Point<float>& point) const;
+
+    // index of a path holding point, or mNone
+    size_t GetPathAt(const Point<float>& point) const;
+
+    // one result per point, for callers with many points to look up at once
+    void GetRoomsAt(const Point<float>* points, const size_t count, size_t* rooms) const;
+
+    void GetPathsAt(const Point<float>* points, const size_t count, size_t* paths) const;
+
+    // appends the indices of the rooms overlapping area
+    void GetRoomsIn(const Rectangle<float>& area, vector<size_t>& rooms) const;
 
-    ~Dungeon();
+    // appends the indices of the paths overlapping area
+    void GetPathsIn(const Rectangle<float>& area, vector<size_t>& paths) const;
+
+    // replaces rooms with the indices of the count rooms closest to point, nearest first
+    void GetRoomsNearest(const Point<float>& point, const size_t count, vector<size_t>& rooms) const;
 
 private:
-    void RenderRoom(
-        SDL_Renderer* renderer,
-        const Room& room,
-        const Point<float>& offset = {}
+    // what generating one subtree produced, merged into the dungeon in subtree order
+    struct Subtree {
+        vector<Room> rooms {};
+        vector<Path> paths {};
+        vector<uint32_t> roomNodes {};
+        vector<uint32_t> pathNodes {};
+    };
+
+    bool SplitRandom(
+        const Rectangle<float>& rectangle,
+        RandomCounter& random,
+        pair<Rectangle<float>, Rectangle<float>>& rectangles
     ) const;
 
-    void RenderRooms(SDL_Renderer* renderer, const Point<float>& offset = {}) const;
+    bool GetCutRange(const float length, const float breadth, const float ratio, pair<float, float>& range) const;
 
-    void RenderPath(
-        SDL_Renderer* renderer,
-        const Path& path,
-        const Point<float>& offset = {}
-    ) const;
+    void SplitRectangle(
+        const Rectangle<float>& container,
+        const size_t iterations,
+        const size_t threads,
+        const size_t depthParallel
+    );
 
-    void RenderPaths(
-        SDL_Renderer* renderer,
-        const Point<float>& offset = {}
+    void GenerateSubtree(
+        const size_t root,
+        const size_t depth,
+        const size_t levels,
+        const RandomCounter& random,
+        Subtree& subtree
     );
 
-    void RenderRectangle(
-        SDL_Renderer* renderer,
-        const Rectangle<float>& rectangle,
-        const Point<float>& offset = {}
-    ) const;
+    void MergeSubtrees(const vector<Subtree>& subtrees);
 
-    void RenderTree(
-        SDL_Renderer* renderer,
-        NodeTreeBinary<Rectangle<float>>* const tree,
-        const Point<float>& offset = {}
-    ) const;
+    void BuildIndex();
 
-    pair<Rectangle<float>, Rectangle<float>> SplitRandom(const Rectangle<float>& rectangle) const;
+    // leaves hold rooms and parents hold paths, so isRoom picks which of them a query wants
+    size_t FindAt(const Point<float>& point, const bool isRoom) const;
 
-    NodeTreeBinary<Rectangle<float>>* SplitRectangle(const Rectangle<float>& container, const size_t iterations) const;
+    void FindIn(const Rectangle<float>& area, const bool isRoom, vector<size_t>& items) const;
 
-    void GenerateRooms();
+    const Rectangle<float>& GetItem(const size_t index, const bool isRoom) const;
 
-    void GeneratePaths(NodeTreeBinary<Rectangle<float>>* const tree, list<Path>& paths);
+    // Depth first over the used nodes without a stack: the heap layout gives every node its
+    // parent and sibling, so unwinding is index math. visit returns whether to go below a node.
+    template<typename Visit>
+    void Walk(Visit visit) const {
+        if (mTree.IsEmpty() || !mTree[0].IsUsed()) {
+            return;
+        }
 
-    void DeleteTree(NodeTreeBinary<Rectangle<float>>* tree);
+        size_t index = 0;
+        while (true) {
+            if (visit(index) && mTree.IsParent(index)) {
+                index = TreeBinary<Rectangle<float>>::GetLeft(index);
+                continue;
+            }
 
-    void AddOffset(SDL_FRect& rect, const Point<float>& offset) const;
+            // climb while on a right child, then step over to the right sibling
+            while (index && !(index & 1)) {
+                index = TreeBinary<Rectangle<float>>::GetParent(index);
+            }
+
+            if (!index) {
+                return;
+            }
+
+            index++;
+        }
+    }
+
+    void SplitNode(const size_t index, RandomCounter& random);
+
+    Room GenerateRoom(const size_t index, RandomCounter& random) const;
+
+    Path GeneratePath(const size_t index) const;
+
+    void AlignPath(Path& path) const;
+
+    void AddTiles(Rasterizer& rasterizer) const;
+
+    static Rasterizer& GetRasterizer(const size_t threads);
 
     Rectangle<float> mCanvas {};
     Point<float> mRatioToDiscard {};
+    uint64_t mSeed {};
+
+    TreeBinary<Rectangle<float>> mTree {};
+    vector<Room> mRooms {};
+    vector<Path> mPaths {};
 
-    NodeTreeBinary<Rectangle<float>>* mTree = nullptr;
-    list<Room> mRooms {};
-    list<Path> mPaths {};
+    // per tree node: the bounds of everything under it and the room or path it holds
+    vector<Rectangle<float>> mBounds {};
+    vector<uint32_t> mItems {};
 
     float mTileSize {};
 };
\ No newline at end of file
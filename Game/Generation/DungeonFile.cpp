@@ -0,0 +1,159 @@
+#include "Game/pch.h"
+#include "Engine/Utility/Miscellaneous.h"
+#include "DungeonFile.h"
+
+// the sections are used in place, so their types must look the same on disk and in memory
+static_assert(is_trivially_copyable_v<Rectangle<float>> && sizeof(Rectangle<float>) == 4 * sizeof(float));
+static_assert(is_trivially_copyable_v<DungeonFile::Header> && sizeof(DungeonFile::Header) == 104);
+static_assert(sizeof(Dungeon::Tile) == 1);
+
+static uint64_t Align(const uint64_t offset, const uint64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+static bool IsSectionInside(const uint64_t offset, const uint64_t count, const uint64_t elementSize, const uint64_t size) {
+    return offset <= size && count <= (size - offset) / elementSize;
+}
+
+DungeonFile::DungeonFile(const string& file) {
+    Open(file);
+}
+
+bool DungeonFile::Save(const string& file, const Dungeon& dungeon, const size_t threads /* = 1 */) {
+    Matrix<Dungeon::Tile> tileMatrix {};
+    dungeon.GenerateTileMatrix(tileMatrix, threads);
+
+    Header header {};
+    header.magic = mMagic;
+    header.version = mVersion;
+    header.seed = dungeon.GetSeed();
+    header.canvas = dungeon.GetCanvas();
+    header.tileSize = dungeon.GetTileSize();
+    header.alignment = mAlignment;
+
+    header.roomCount = dungeon.GetRooms().size();
+    header.roomOffset = Align(sizeof(Header), mAlignment);
+    header.pathCount = dungeon.GetPaths().size();
+    header.pathOffset = Align(header.roomOffset + header.roomCount * sizeof(Rectangle<float>), mAlignment);
+
+    header.tileWidth = (uint32_t)tileMatrix.GetWidth();
+    header.tileHeight = (uint32_t)tileMatrix.GetHeight();
+    header.tileStride = tileMatrix.GetStride();
+    header.tileOffset = Align(header.pathOffset + header.pathCount * sizeof(Rectangle<float>), mAlignment);
+
+    header.size = header.tileOffset + header.tileStride * header.tileHeight;
+
+    ofstream stream(file, ios::binary | ios::trunc);
+    LOG_AND_RETURN_IF(!stream, "The file \"" + file + "\" could not be created!", LOG_TYPE_WARNING, false);
+
+    const auto pad = [&](const uint64_t offset) {
+        static const char zeros[mAlignment] {};
+        stream.write(zeros, offset - (uint64_t)stream.tellp());
+    };
+
+    stream.write((const char*)&header, sizeof(header));
+
+    pad(header.roomOffset);
+    for (const auto& room : dungeon.GetRooms()) {
+        stream.write((const char*)&room.GetRectangle(), sizeof(Rectangle<float>));
+    }
+
+    pad(header.pathOffset);
+    for (const auto& path : dungeon.GetPaths()) {
+        stream.write((const char*)&path.GetRectangle(), sizeof(Rectangle<float>));
+    }
+
+    pad(header.tileOffset);
+    stream.write((const char*)tileMatrix.GetData(), header.tileStride * header.tileHeight);
+
+    LOG_AND_RETURN_IF(!stream, "The file \"" + file + "\" could not be written!", LOG_TYPE_WARNING, false);
+    return true;
+}
+
+bool DungeonFile::Open(const string& file) {
+    Close();
+
+    if (!mFileMapped.Open(file)) {
+        return false;
+    }
+
+    if (!IsValid(file)) {
+        Close();
+        return false;
+    }
+
+    mHeader = GetSection<Header>(0);
+    return true;
+}
+
+void DungeonFile::Close() {
+    mFileMapped.Close();
+    mHeader = nullptr;
+}
+
+bool DungeonFile::IsOpen() const {
+    return mHeader;
+}
+
+const DungeonFile::Header& DungeonFile::GetHeader() const {
+    return *mHeader;
+}
+
+const Rectangle<float>* DungeonFile::GetRooms() const {
+    return GetSection<Rectangle<float>>(mHeader->roomOffset);
+}
+
+size_t DungeonFile::GetRoomCount() const {
+    return (size_t)mHeader->roomCount;
+}
+
+const Rectangle<float>* DungeonFile::GetPaths() const {
+    return GetSection<Rectangle<float>>(mHeader->pathOffset);
+}
+
+size_t DungeonFile::GetPathCount() const {
+    return (size_t)mHeader->pathCount;
+}
+
+const Dungeon::Tile* DungeonFile::GetTileMatrix() const {
+    return GetSection<Dungeon::Tile>(mHeader->tileOffset);
+}
+
+const Dungeon::Tile* DungeonFile::GetTileRow(const size_t y) const {
+    return GetTileMatrix() + y * mHeader->tileStride;
+}
+
+size_t DungeonFile::GetTileMatrixWidth() const {
+    return mHeader->tileWidth;
+}
+
+size_t DungeonFile::GetTileMatrixHeight() const {
+    return mHeader->tileHeight;
+}
+
+size_t DungeonFile::GetTileMatrixStride() const {
+    return (size_t)mHeader->tileStride;
+}
+
+bool DungeonFile::IsValid(const string& file) const {
+    const auto size = (uint64_t)mFileMapped.GetSize();
+    LOG_AND_RETURN_IF(size < sizeof(Header), "The dungeon file \"" + file + "\" is too small!", LOG_TYPE_WARNING, false);
+
+    const auto& header = *GetSection<Header>(0);
+    LOG_AND_RETURN_IF(header.magic != mMagic, "The file \"" + file + "\" is not a dungeon file!", LOG_TYPE_WARNING, false);
+    LOG_AND_RETURN_IF(header.version != mVersion, "The dungeon file \"" + file + "\" has the unsupported version " + to_string(header.version) + '!', LOG_TYPE_WARNING, false);
+
+    // sections must stay aligned for the pointers handed out into them
+    const auto alignment = header.alignment;
+    const auto isAligned = alignment && !(alignment & (alignment - 1)) &&
+        !(header.roomOffset % alignment) && !(header.pathOffset % alignment) && !(header.tileOffset % alignment);
+
+    const auto isInside = header.size <= size &&
+        IsSectionInside(header.roomOffset, header.roomCount, sizeof(Rectangle<float>), header.size) &&
+        IsSectionInside(header.pathOffset, header.pathCount, sizeof(Rectangle<float>), header.size) &&
+        header.tileStride >= header.tileWidth &&
+        (!header.tileStride || IsSectionInside(header.tileOffset, header.tileHeight, header.tileStride, header.size));
+
+    LOG_AND_RETURN_IF(!isAligned || !isInside, "The dungeon file \"" + file + "\" is corrupted!", LOG_TYPE_WARNING, false);
+    return true;
+}
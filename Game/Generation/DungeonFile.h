@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Dungeon.h"
+
+#include "Engine/Utility/FileMapped.h"
+
+// Binary image of a Dungeon: a header, then the room rectangles, the path rectangles and the
+// tile matrix, every section starting on its own page. Opening one maps the file and hands out
+// pointers into the mapping, so nothing is parsed or copied. Values keep the byte order of the
+// machine that saved them, a file from a machine of the other order fails on the magic.
+class DungeonFile {
+public:
+    static constexpr uint32_t mMagic = 'D' | ('N' << 8) | ('G' << 16) | ('N' << 24);
+    static constexpr uint32_t mVersion = 1;
+    static constexpr uint32_t mAlignment = 4096;
+
+    struct Header {
+        uint32_t magic {};
+        uint32_t version {};
+        uint64_t seed {};
+
+        Rectangle<float> canvas {};
+        float tileSize {};
+        uint32_t alignment {};
+
+        uint64_t roomCount {};
+        uint64_t roomOffset {};
+        uint64_t pathCount {};
+        uint64_t pathOffset {};
+
+        uint32_t tileWidth {};
+        uint32_t tileHeight {};
+        uint64_t tileStride {};
+        uint64_t tileOffset {};
+
+        uint64_t size {};
+    };
+
+    DungeonFile() = default;
+
+    DungeonFile(const string& file);
+
+    static bool Save(const string& file, const Dungeon& dungeon, const size_t threads = 1);
+
+    bool Open(const string& file);
+
+    void Close();
+
+    bool IsOpen() const;
+
+    const Header& GetHeader() const;
+
+    const Rectangle<float>* GetRooms() const;
+
+    size_t GetRoomCount() const;
+
+    const Rectangle<float>* GetPaths() const;
+
+    size_t GetPathCount() const;
+
+    // rows are GetTileMatrixStride tiles apart
+    const Dungeon::Tile* GetTileMatrix() const;
+
+    const Dungeon::Tile* GetTileRow(const size_t y) const;
+
+    size_t GetTileMatrixWidth() const;
+
+    size_t GetTileMatrixHeight() const;
+
+    size_t GetTileMatrixStride() const;
+
+private:
+    bool IsValid(const string& file) const;
+
+    template<typename T>
+    const T* GetSection(const uint64_t offset) const {
+        return (const T*)(mFileMapped.GetData() + offset);
+    }
+
+    FileMapped mFileMapped {};
+    const Header* mHeader = nullptr;
+};
\ No newline at end of file
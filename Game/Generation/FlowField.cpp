@@ -0,0 +1,417 @@
+#include "Game/pch.h"
+#include "FlowField.h"
+
+FlowField::FlowField(const Dungeon& dungeon, const size_t threads /* = 1 */, const int32_t regionSize /* = 64 */)
+    : mRegionSize(max(regionSize, 1)),
+    mThreads(max<size_t>(threads, 1)) {
+    Matrix<Dungeon::Tile> tileMatrix {};
+    dungeon.GenerateTileMatrix(tileMatrix, mThreads);
+
+    mWidth = (int32_t)tileMatrix.GetWidth();
+    mHeight = (int32_t)tileMatrix.GetHeight();
+
+    const auto size = (size_t)mWidth * mHeight;
+    mWalkable.resize(size);
+    for (int32_t y = 0; y < mHeight; y++) {
+        for (int32_t x = 0; x < mWidth; x++) {
+            mWalkable[(size_t)y * mWidth + x] = tileMatrix[y][x] != Dungeon::Tile::NONE;
+        }
+    }
+
+    mDistances.assign(size, mDistanceNone);
+    mOwners.assign(size, mDistanceNone);
+    mDirections.assign(size, Direction::NONE);
+
+    mRegionsX = (mWidth + mRegionSize - 1) / mRegionSize;
+    mRegionsY = (mHeight + mRegionSize - 1) / mRegionSize;
+
+    mRegions.resize((size_t)mRegionsX * mRegionsY);
+    for (int32_t y = 0; y < mRegionsY; y++) {
+        for (int32_t x = 0; x < mRegionsX; x++) {
+            auto& region = mRegions[(size_t)y * mRegionsX + x];
+            region.x = x * mRegionSize;
+            region.y = y * mRegionSize;
+            region.w = min(mRegionSize, mWidth - region.x);
+            region.h = min(mRegionSize, mHeight - region.y);
+        }
+    }
+}
+
+void FlowField::SetGoals(const vector<Tile>& goals) {
+    mGoals = goals;
+    Fill();
+}
+
+void FlowField::MoveGoal(const size_t goal, const Tile& tile) {
+    if (goal >= mGoals.size()) {
+        return;
+    }
+
+    size_t owned = 0, reached = 0;
+    mBatch.clear();
+    for (size_t i = 0; i < mRegions.size(); i++) {
+        const auto& region = mRegions[i];
+        for (const auto count : region.owned) {
+            reached += count;
+        }
+
+        if (region.owned[goal]) {
+            owned += region.owned[goal];
+            mBatch.push_back(i);
+        }
+    }
+
+    mGoals[goal] = tile;
+
+    // clearing and refilling most of the tiles costs more than filling all of them once
+    if (owned * 2 > reached) {
+        Fill();
+        return;
+    }
+
+    // the tiles of the other goals keep true distances, only the ones this goal held start over
+    ForEach(mBatch, [&](Region& region) {
+        Reset(region, (uint32_t)goal);
+    });
+
+    SetGoal((uint32_t)goal);
+
+    Update();
+}
+
+uint32_t FlowField::GetDistance(const Tile& tile) const {
+    return IsInside(tile) ? mDistances[(size_t)tile.GetY() * mWidth + tile.GetX()] : mDistanceNone;
+}
+
+FlowField::Direction FlowField::GetDirection(const Tile& tile) const {
+    return IsInside(tile) ? mDirections[(size_t)tile.GetY() * mWidth + tile.GetX()] : Direction::NONE;
+}
+
+FlowField::Tile FlowField::GetNext(const Tile& tile) const {
+    switch (GetDirection(tile)) {
+        case Direction::LEFT:
+            return { tile.GetX() - 1, tile.GetY() };
+
+        case Direction::RIGHT:
+            return { tile.GetX() + 1, tile.GetY() };
+
+        case Direction::UP:
+            return { tile.GetX(), tile.GetY() - 1 };
+
+        case Direction::DOWN:
+            return { tile.GetX(), tile.GetY() + 1 };
+
+        default:
+            return tile;
+    }
+}
+
+uint32_t FlowField::GetGoal(const Tile& tile) const {
+    return IsInside(tile) ? mOwners[(size_t)tile.GetY() * mWidth + tile.GetX()] : mDistanceNone;
+}
+
+const vector<FlowField::Tile>& FlowField::GetGoals() const {
+    return mGoals;
+}
+
+bool FlowField::IsWalkable(const Tile& tile) const {
+    return IsInside(tile) && mWalkable[(size_t)tile.GetY() * mWidth + tile.GetX()];
+}
+
+int32_t FlowField::GetWidth() const {
+    return mWidth;
+}
+
+int32_t FlowField::GetHeight() const {
+    return mHeight;
+}
+
+size_t FlowField::GetRegionRuns() const {
+    return mRegionRuns;
+}
+
+void FlowField::Fill() {
+    fill(mDistances.begin(), mDistances.end(), mDistanceNone);
+    fill(mOwners.begin(), mOwners.end(), mDistanceNone);
+
+    for (auto& region : mRegions) {
+        region.owned.assign(mGoals.size(), 0);
+        region.isTouched = true;
+    }
+
+    for (uint32_t i = 0; i < (uint32_t)mGoals.size(); i++) {
+        SetGoal(i);
+    }
+
+    Update();
+}
+
+void FlowField::Update() {
+    mRegionRuns = 0;
+
+    const auto markDirty = [&](const int32_t x, const int32_t y) {
+        if (x >= 0 && y >= 0 && x < mRegionsX && y < mRegionsY) {
+            mRegions[(size_t)y * mRegionsX + x].isDirty = true;
+        }
+    };
+
+    // a region only reads the borders of the four around it, which have the other colour
+    for (bool isAnyDirty = true; isAnyDirty;) {
+        isAnyDirty = false;
+
+        for (int32_t colour = 0; colour < 2; colour++) {
+            mBatch.clear();
+            for (size_t i = 0; i < mRegions.size(); i++) {
+                const auto x = (int32_t)(i % mRegionsX);
+                const auto y = (int32_t)(i / mRegionsX);
+
+                if (mRegions[i].isDirty && ((x + y) & 1) == colour) {
+                    mBatch.push_back(i);
+                }
+            }
+
+            if (mBatch.empty()) {
+                continue;
+            }
+
+            isAnyDirty = true;
+            mRegionRuns += mBatch.size();
+
+            ForEach(mBatch, [&](Region& region) {
+                RunRegion(region);
+            });
+
+            for (const auto i : mBatch) {
+                auto& region = mRegions[i];
+                region.isDirty = false;
+
+                if (!region.isChanged) {
+                    continue;
+                }
+
+                region.isChanged = false;
+                region.isTouched = true;
+
+                const auto x = (int32_t)(i % mRegionsX);
+                const auto y = (int32_t)(i / mRegionsX);
+                markDirty(x - 1, y);
+                markDirty(x + 1, y);
+                markDirty(x, y - 1);
+                markDirty(x, y + 1);
+            }
+        }
+    }
+
+    // the tiles on the border of a region point across it, so the regions around change too
+    mBatch.clear();
+    for (size_t i = 0; i < mRegions.size(); i++) {
+        const auto x = (int32_t)(i % mRegionsX);
+        const auto y = (int32_t)(i / mRegionsX);
+
+        const auto isTouched = [&](const int32_t xOther, const int32_t yOther) {
+            return xOther >= 0 && yOther >= 0 && xOther < mRegionsX && yOther < mRegionsY &&
+                   mRegions[(size_t)yOther * mRegionsX + xOther].isTouched;
+        };
+
+        if (isTouched(x, y) || isTouched(x - 1, y) || isTouched(x + 1, y) || isTouched(x, y - 1) || isTouched(x, y + 1)) {
+            mBatch.push_back(i);
+        }
+    }
+
+    ForEach(mBatch, [&](Region& region) {
+        SetDirections(region);
+    });
+
+    for (auto& region : mRegions) {
+        region.isTouched = false;
+    }
+}
+
+void FlowField::RunRegion(Region& region) {
+    auto& open = region.open;
+    open.clear();
+
+    const auto xLast = region.x + region.w - 1;
+    const auto yLast = region.y + region.h - 1;
+
+    // Only tiles that can lower a neighbour seed the search: the ones on the edge that took a
+    // shorter distance from the regions around, and the ones next to a tile farther than a step,
+    // which is where a reset or a new goal left a gap. The rest already agree with each other.
+    for (auto y = region.y; y <= yLast; y++) {
+        for (auto x = region.x; x <= xLast; x++) {
+            const auto index = (uint32_t)((size_t)y * mWidth + x);
+            if (!mWalkable[index]) {
+                continue;
+            }
+
+            auto isSeed = false;
+
+            const pair<bool, uint32_t> outside[] = {
+                { x == region.x && x > 0, index - 1 },
+                { x == xLast && x + 1 < mWidth, index + 1 },
+                { y == region.y && y > 0, index - (uint32_t)mWidth },
+                { y == yLast && y + 1 < mHeight, index + (uint32_t)mWidth }
+            };
+
+            for (const auto& [isOutside, neighbour] : outside) {
+                if (isOutside && mDistances[neighbour] != mDistanceNone && mDistances[neighbour] + 1 < mDistances[index]) {
+                    mDistances[index] = mDistances[neighbour] + 1;
+                    SetOwner(region, index, mOwners[neighbour]);
+                    region.isChanged = true;
+                    isSeed = true;
+                }
+            }
+
+            const auto distance = mDistances[index];
+            if (distance == mDistanceNone) {
+                continue;
+            }
+
+            const pair<bool, uint32_t> inside[] = {
+                { x > region.x, index - 1 },
+                { x < xLast, index + 1 },
+                { y > region.y, index - (uint32_t)mWidth },
+                { y < yLast, index + (uint32_t)mWidth }
+            };
+
+            for (const auto& [isInside, neighbour] : inside) {
+                isSeed = isSeed || (isInside && mWalkable[neighbour] && distance + 1 < mDistances[neighbour]);
+            }
+
+            if (isSeed) {
+                open.push_back({ distance, index });
+            }
+        }
+    }
+
+    // every step costs the same, so the seeds in order merged with a queue of what they reach
+    // pop in order of distance without a heap
+    sort(open.begin(), open.end());
+
+    auto& queue = region.queue;
+    queue.clear();
+
+    size_t seed = 0, front = 0;
+    while (seed < open.size() || front < queue.size()) {
+        const auto isSeed = front == queue.size() || (seed < open.size() && open[seed].first <= queue[front].first);
+        const auto [distance, index] = isSeed ? open[seed++] : queue[front++];
+
+        if (distance > mDistances[index]) {
+            continue;
+        }
+
+        const auto x = (int32_t)(index % mWidth);
+        const auto y = (int32_t)(index / mWidth);
+
+        const pair<bool, uint32_t> inside[] = {
+            { x > region.x, index - 1 },
+            { x < xLast, index + 1 },
+            { y > region.y, index - (uint32_t)mWidth },
+            { y < yLast, index + (uint32_t)mWidth }
+        };
+
+        for (const auto& [isInside, neighbour] : inside) {
+            if (isInside && mWalkable[neighbour] && distance + 1 < mDistances[neighbour]) {
+                mDistances[neighbour] = distance + 1;
+                SetOwner(region, neighbour, mOwners[index]);
+                region.isChanged = true;
+
+                queue.push_back({ distance + 1, neighbour });
+            }
+        }
+    }
+}
+
+void FlowField::SetDirections(const Region& region) {
+    for (auto y = region.y; y < region.y + region.h; y++) {
+        for (auto x = region.x; x < region.x + region.w; x++) {
+            const auto index = (uint32_t)((size_t)y * mWidth + x);
+
+            auto best = mDistances[index];
+            auto direction = Direction::NONE;
+
+            const tuple<bool, uint32_t, Direction> neighbours[] = {
+                { x > 0, index - 1, Direction::LEFT },
+                { x + 1 < mWidth, index + 1, Direction::RIGHT },
+                { y > 0, index - (uint32_t)mWidth, Direction::UP },
+                { y + 1 < mHeight, index + (uint32_t)mWidth, Direction::DOWN }
+            };
+
+            // walls and unreached tiles hold mDistanceNone, which no neighbour gets under
+            for (const auto& [isInside, neighbour, step] : neighbours) {
+                if (isInside && mWalkable[index] && mWalkable[neighbour] && mDistances[neighbour] < best) {
+                    best = mDistances[neighbour];
+                    direction = step;
+                }
+            }
+
+            mDirections[index] = direction;
+        }
+    }
+}
+
+void FlowField::Reset(Region& region, const uint32_t goal) {
+    for (auto y = region.y; y < region.y + region.h; y++) {
+        for (auto x = region.x; x < region.x + region.w; x++) {
+            const auto index = (size_t)y * mWidth + x;
+
+            if (mOwners[index] == goal) {
+                mDistances[index] = mDistanceNone;
+                mOwners[index] = mDistanceNone;
+
+                region.isDirty = true;
+                region.isTouched = true;
+            }
+        }
+    }
+
+    region.owned[goal] = 0;
+}
+
+void FlowField::SetGoal(const uint32_t goal) {
+    const auto& tile = mGoals[goal];
+    if (!IsWalkable(tile)) {
+        return;
+    }
+
+    const auto index = (uint32_t)((size_t)tile.GetY() * mWidth + tile.GetX());
+    auto& region = mRegions[GetRegionAt(index)];
+
+    if (mDistances[index]) {
+        mDistances[index] = 0;
+        SetOwner(region, index, goal);
+    }
+
+    region.isDirty = true;
+    region.isTouched = true;
+}
+
+void FlowField::SetOwner(Region& region, const uint32_t index, const uint32_t goal) {
+    // only ever called for tiles of region, so the counts need no lock
+    if (mOwners[index] != mDistanceNone) {
+        region.owned[mOwners[index]]--;
+    }
+
+    region.owned[goal]++;
+    mOwners[index] = goal;
+}
+
+size_t FlowField::GetRegionAt(const uint32_t index) const {
+    const auto x = (int32_t)(index % mWidth) / mRegionSize;
+    const auto y = (int32_t)(index / mWidth) / mRegionSize;
+
+    return (size_t)y * mRegionsX + x;
+}
+
+bool FlowField::IsInside(const Tile& tile) const {
+    return tile.GetX() >= 0 && tile.GetY() >= 0 && tile.GetX() < mWidth && tile.GetY() < mHeight;
+}
+
+ThreadPool& FlowField::GetThreadPool() {
+    // the calling thread runs regions too
+    if (!mThreadPool) {
+        mThreadPool = make_unique<ThreadPool>(mThreads - 1);
+    }
+
+    return *mThreadPool;
+}
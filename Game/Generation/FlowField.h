@@ -0,0 +1,136 @@
+#pragma once
+
+#include "Dungeon.h"
+
+#include "Engine/Utility/ThreadPool.h"
+
+// Distances from every walkable tile of a dungeon to its nearest goal, and the step toward it,
+// so any number of agents heading for the same goals steer with one lookup each instead of a
+// search each. The tile matrix is cut into square regions: a region runs a breadth first search
+// over its own tiles, seeded with its distances and the borders of the regions around it, and
+// the regions of one colour of a checkerboard run at the same time, since none of them reads what
+// another one writes. Regions run again until no border changes. Moving a goal clears only the
+// tiles it was nearest to, and only the regions those tiles are in, or that the change spreads
+// to, run again. A goal nearest to most of the tiles, as a lone goal always is, starts everything
+// over instead, which costs less than clearing and refilling nearly all of them.
+class FlowField {
+public:
+    // tiles in the tile matrix of the dungeon, x to the right and y down
+    using Tile = Point<int32_t>;
+
+    enum class Direction : uint8_t {
+        NONE,
+        LEFT,
+        RIGHT,
+        UP,
+        DOWN
+    };
+
+    static constexpr uint32_t mDistanceNone = numeric_limits<uint32_t>::max();
+
+    FlowField(const Dungeon& dungeon, const size_t threads = 1, const int32_t regionSize = 64);
+
+    // goals that are not walkable are kept but never reached
+    void SetGoals(const vector<Tile>& goals);
+
+    void MoveGoal(const size_t goal, const Tile& tile);
+
+    // steps to the nearest goal, mDistanceNone when none can be reached or tile is a wall
+    uint32_t GetDistance(const Tile& tile) const;
+
+    // the step that gets closer to the nearest goal, NONE on goals and where no goal is reachable
+    Direction GetDirection(const Tile& tile) const;
+
+    // tile after the step, tile itself when there is none
+    Tile GetNext(const Tile& tile) const;
+
+    // index into the goals of the goal nearest to tile, or mDistanceNone
+    uint32_t GetGoal(const Tile& tile) const;
+
+    const vector<Tile>& GetGoals() const;
+
+    bool IsWalkable(const Tile& tile) const;
+
+    int32_t GetWidth() const;
+
+    int32_t GetHeight() const;
+
+    // regions that ran in the last update, counting every run
+    size_t GetRegionRuns() const;
+
+private:
+    struct Region {
+        int32_t x {};
+        int32_t y {};
+        int32_t w {};
+        int32_t h {};
+
+        bool isDirty = false;
+        bool isChanged = false;
+        bool isTouched = false;
+
+        // per goal, the tiles of the region it is nearest to
+        vector<uint32_t> owned {};
+
+        // the seeds and the tiles they reach, as distance and index
+        vector<pair<uint32_t, uint32_t>> open {};
+        vector<pair<uint32_t, uint32_t>> queue {};
+    };
+
+    // fills every tile from scratch for the current goals
+    void Fill();
+
+    // runs the dirty regions until none is left, then points the tiles of the touched ones
+    void Update();
+
+    void RunRegion(Region& region);
+
+    void SetDirections(const Region& region);
+
+    void Reset(Region& region, const uint32_t goal);
+
+    void SetGoal(const uint32_t goal);
+
+    void SetOwner(Region& region, const uint32_t index, const uint32_t goal);
+
+    size_t GetRegionAt(const uint32_t index) const;
+
+    bool IsInside(const Tile& tile) const;
+
+    ThreadPool& GetThreadPool();
+
+    template<typename Function>
+    void ForEach(const vector<size_t>& regions, Function&& function) {
+        if (mThreads <= 1 || regions.size() <= 1) {
+            for (const auto region : regions) {
+                function(mRegions[region]);
+            }
+
+            return;
+        }
+
+        GetThreadPool().ForEach(regions.size(), [&](const size_t i) {
+            function(mRegions[regions[i]]);
+        });
+    }
+
+    int32_t mWidth {};
+    int32_t mHeight {};
+    int32_t mRegionSize {};
+    int32_t mRegionsX {};
+    int32_t mRegionsY {};
+
+    vector<uint8_t> mWalkable {};
+    vector<uint32_t> mDistances {};
+    vector<uint32_t> mOwners {};
+    vector<Direction> mDirections {};
+
+    vector<Tile> mGoals {};
+
+    vector<Region> mRegions {};
+    vector<size_t> mBatch {};
+    size_t mRegionRuns {};
+
+    size_t mThreads {};
+    unique_ptr<ThreadPool> mThreadPool {};
+};
\ No newline at end of file
@@ -0,0 +1,502 @@
+#include "Game/pch.h"
+#include "Pathfinder.h"
+
+void Pathfinder::Scratch::Reset(const size_t size) {
+    if (lengths.size() != size) {
+        lengths.resize(size);
+        parents.resize(size);
+        stamps.assign(size, 0);
+        stamp = 0;
+    }
+
+    // after wrapping around the old stamps could match again
+    if (!++stamp) {
+        fill(stamps.begin(), stamps.end(), 0);
+        stamp = 1;
+    }
+
+    open.clear();
+}
+
+bool Pathfinder::Scratch::IsVisited(const uint32_t index) const {
+    return stamps[index] == stamp;
+}
+
+void Pathfinder::Scratch::Visit(const uint32_t index, const uint32_t length, const uint32_t parent) {
+    stamps[index] = stamp;
+    lengths[index] = length;
+    parents[index] = parent;
+}
+
+Pathfinder::Pathfinder(const Dungeon& dungeon, const size_t cacheCapacity /* = 1024 */)
+    : mCacheCapacity(max<size_t>(cacheCapacity, 1)) {
+    Matrix<Dungeon::Tile> tileMatrix {};
+    dungeon.GenerateTileMatrix(tileMatrix);
+
+    mWidth = (int32_t)tileMatrix.GetWidth();
+    mHeight = (int32_t)tileMatrix.GetHeight();
+
+    mWalkable.resize((size_t)mWidth * mHeight);
+    for (int32_t y = 0; y < mHeight; y++) {
+        for (int32_t x = 0; x < mWidth; x++) {
+            mWalkable[(size_t)y * mWidth + x] = tileMatrix[y][x] != Dungeon::Tile::NONE;
+        }
+    }
+
+    BuildClusters(dungeon);
+    BuildEntrances();
+    BuildEdges();
+}
+
+bool Pathfinder::IsWalkable(const Tile& tile) const {
+    if (tile.GetX() < 0 || tile.GetY() < 0 || tile.GetX() >= mWidth || tile.GetY() >= mHeight) {
+        return false;
+    }
+
+    const auto index = GetIndex(tile);
+    return mWalkable[index] && mClusters[index] != mLengthNone;
+}
+
+bool Pathfinder::FindRoute(const Tile& start, const Tile& goal, Route& route) {
+    if (!IsWalkable(start) || !IsWalkable(goal)) {
+        return false;
+    }
+
+    const auto key = GetKey(GetIndex(start), GetIndex(goal));
+    const auto it = mRoutesIndex.find(key);
+    if (it != mRoutesIndex.end()) {
+        mRoutes.splice(mRoutes.begin(), mRoutes, it->second);
+        route = it->second->route;
+
+        mStatistics.routesCached++;
+        return true;
+    }
+
+    mStatistics.routes++;
+
+    Route found {};
+    if (SearchRoute(GetIndex(start), GetIndex(goal), found) == mLengthNone) {
+        return false;
+    }
+
+    mRoutes.push_front({ key, found });
+    mRoutesIndex[key] = mRoutes.begin();
+
+    if (mRoutes.size() > mCacheCapacity) {
+        mRoutesIndex.erase(mRoutes.back().key);
+        mRoutes.pop_back();
+    }
+
+    route = move(found);
+    return true;
+}
+
+bool Pathfinder::Refine(const Route& route, const size_t segment, vector<Tile>& tiles) {
+    if (segment + 1 >= route.waypoints.size()) {
+        return false;
+    }
+
+    const auto from = GetIndex(route.waypoints[segment]);
+    const auto to = GetIndex(route.waypoints[segment + 1]);
+    const auto key = GetKey(from, to);
+
+    auto it = mSegments.find(key);
+    if (it != mSegments.end()) {
+        mStatistics.segmentsCached++;
+    } else {
+        mStatistics.segments++;
+
+        // waypoints in different clusters are the two sides of an entrance, one step apart
+        mPath.clear();
+        if (mClusters[from] != mClusters[to]) {
+            mPath.push_back(to);
+        } else if (Search(from, to, mClusters[from], &mPath) == mLengthNone) {
+            return false;
+        }
+
+        if (mSegments.size() >= mCacheCapacity) {
+            mSegments.clear();
+        }
+
+        it = mSegments.emplace(key, mPath).first;
+    }
+
+    // the segments are kept as the search leaves them, goal first
+    for (auto index = it->second.rbegin(); index != it->second.rend(); index++) {
+        tiles.push_back(GetTile(*index));
+    }
+
+    return true;
+}
+
+bool Pathfinder::FindPath(const Tile& start, const Tile& goal, vector<Tile>& tiles) {
+    Route route {};
+    if (!FindRoute(start, goal, route)) {
+        return false;
+    }
+
+    tiles.clear();
+    tiles.push_back(start);
+
+    for (size_t i = 0; i + 1 < route.waypoints.size(); i++) {
+        if (!Refine(route, i, tiles)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Pathfinder::FindPathFlat(const Tile& start, const Tile& goal, vector<Tile>& tiles) {
+    if (!IsWalkable(start) || !IsWalkable(goal)) {
+        return false;
+    }
+
+    mPath.clear();
+    if (Search(GetIndex(start), GetIndex(goal), mLengthNone, &mPath) == mLengthNone) {
+        return false;
+    }
+
+    tiles.clear();
+    tiles.push_back(start);
+    for (auto index = mPath.rbegin(); index != mPath.rend(); index++) {
+        tiles.push_back(GetTile(*index));
+    }
+
+    return true;
+}
+
+size_t Pathfinder::GetClusterCount() const {
+    return mClusterNodes.size();
+}
+
+size_t Pathfinder::GetEntranceCount() const {
+    return mEntrances;
+}
+
+const Pathfinder::Statistics& Pathfinder::GetStatistics() const {
+    return mStatistics;
+}
+
+void Pathfinder::ClearCache() {
+    mRoutes.clear();
+    mRoutesIndex.clear();
+    mSegments.clear();
+}
+
+void Pathfinder::BuildClusters(const Dungeon& dungeon) {
+    const auto& tree = dungeon.GetTree();
+    const auto tileSize = dungeon.GetTileSize();
+
+    mClusters.assign(mWalkable.size(), mLengthNone);
+
+    // the leaf cells cover the canvas without overlapping, a tile goes to the cell holding its centre
+    for (size_t i = 0; i < tree.GetSize(); i++) {
+        if (!tree.IsLeaf(i)) {
+            continue;
+        }
+
+        const auto& cell = tree[i].GetLeaf();
+        const auto xFirst = max(0, (int32_t)ceil(cell.GetX() / tileSize - 0.5f));
+        const auto xLast = min(mWidth, (int32_t)ceil((cell.GetX() + cell.GetW()) / tileSize - 0.5f));
+        const auto yFirst = max(0, (int32_t)ceil(cell.GetY() / tileSize - 0.5f));
+        const auto yLast = min(mHeight, (int32_t)ceil((cell.GetY() + cell.GetH()) / tileSize - 0.5f));
+
+        const auto cluster = (uint32_t)mClusterNodes.size();
+        for (auto y = yFirst; y < yLast; y++) {
+            fill_n(&mClusters[(size_t)y * mWidth + xFirst], max(xLast - xFirst, 0), cluster);
+        }
+
+        mClusterNodes.emplace_back();
+    }
+}
+
+void Pathfinder::BuildEntrances() {
+    const auto isCrossing = [&](const uint32_t one, const uint32_t two) {
+        return mWalkable[one] && mWalkable[two] && mClusters[one] != mClusters[two] &&
+               mClusters[one] != mLengthNone && mClusters[two] != mLengthNone;
+    };
+
+    // Walks every border line between two rows or columns of tiles. Crossings next to each other
+    // between the same two clusters are one entrance, placed in the middle of the run.
+    const auto addRuns = [&](const int32_t lines, const int32_t length, const auto getPair) {
+        for (int32_t line = 0; line < lines; line++) {
+            int32_t runFirst = -1;
+
+            for (int32_t i = 0; i <= length; i++) {
+                const auto isRun = i < length && isCrossing(getPair(line, i).first, getPair(line, i).second);
+
+                if (runFirst >= 0) {
+                    const auto first = getPair(line, runFirst);
+                    const auto isSame = isRun &&
+                                        mClusters[getPair(line, i).first] == mClusters[first.first] &&
+                                        mClusters[getPair(line, i).second] == mClusters[first.second];
+
+                    if (!isSame) {
+                        const auto middle = getPair(line, (runFirst + i - 1) / 2);
+                        AddEntrance(middle.first, middle.second);
+                        runFirst = -1;
+                    }
+                }
+
+                if (isRun && runFirst < 0) {
+                    runFirst = i;
+                }
+            }
+        }
+    };
+
+    addRuns(mWidth - 1, mHeight, [&](const int32_t x, const int32_t y) {
+        const auto index = (uint32_t)((size_t)y * mWidth + x);
+        return pair<uint32_t, uint32_t>(index, index + 1);
+    });
+
+    addRuns(mHeight - 1, mWidth, [&](const int32_t y, const int32_t x) {
+        const auto index = (uint32_t)((size_t)y * mWidth + x);
+        return pair<uint32_t, uint32_t>(index, index + (uint32_t)mWidth);
+    });
+}
+
+void Pathfinder::AddEntrance(const uint32_t tileOne, const uint32_t tileTwo) {
+    const auto nodeOne = AddNode(tileOne);
+    const auto nodeTwo = AddNode(tileTwo);
+
+    mNodes[nodeOne].edges.push_back({ nodeTwo, 1 });
+    mNodes[nodeTwo].edges.push_back({ nodeOne, 1 });
+
+    mEntrances++;
+}
+
+uint32_t Pathfinder::AddNode(const uint32_t tile) {
+    const auto [it, isAdded] = mNodeAt.emplace(tile, (uint32_t)mNodes.size());
+    if (!isAdded) {
+        return it->second;
+    }
+
+    const auto cluster = mClusters[tile];
+    mNodes.push_back({ tile, cluster, (uint32_t)mClusterNodes[cluster].size() });
+    mClusterNodes[cluster].push_back(it->second);
+
+    return it->second;
+}
+
+void Pathfinder::BuildEdges() {
+    vector<uint32_t> lengths {};
+
+    for (const auto& nodes : mClusterNodes) {
+        for (const auto node : nodes) {
+            GetLengthsToNodes(mNodes[node].tile, lengths);
+
+            for (size_t i = 0; i < nodes.size(); i++) {
+                if (nodes[i] != node && lengths[i] != mLengthNone) {
+                    mNodes[node].edges.push_back({ nodes[i], lengths[i] });
+                }
+            }
+        }
+    }
+}
+
+void Pathfinder::GetLengthsToNodes(const uint32_t tile, vector<uint32_t>& lengths) {
+    const auto cluster = mClusters[tile];
+    const auto& nodes = mClusterNodes[cluster];
+
+    // every step costs the same, so breadth first finds the shortest lengths
+    auto& scratch = mScratchTiles;
+    scratch.Reset(mWalkable.size());
+    scratch.Visit(tile, 0, tile);
+    scratch.open.push_back({ 0, tile });
+
+    for (size_t i = 0; i < scratch.open.size(); i++) {
+        const auto index = scratch.open[i].second;
+        const auto length = scratch.lengths[index] + 1;
+        const auto x = (int32_t)(index % mWidth);
+        const auto y = (int32_t)(index / mWidth);
+
+        const pair<bool, uint32_t> neighbours[] = {
+            { x > 0, index - 1 },
+            { x + 1 < mWidth, index + 1 },
+            { y > 0, index - (uint32_t)mWidth },
+            { y + 1 < mHeight, index + (uint32_t)mWidth }
+        };
+
+        for (const auto& [isInside, neighbour] : neighbours) {
+            if (isInside && mWalkable[neighbour] && mClusters[neighbour] == cluster && !scratch.IsVisited(neighbour)) {
+                scratch.Visit(neighbour, length, index);
+                scratch.open.push_back({ length, neighbour });
+            }
+        }
+    }
+
+    lengths.resize(nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const auto nodeTile = mNodes[nodes[i]].tile;
+        lengths[i] = scratch.IsVisited(nodeTile) ? scratch.lengths[nodeTile] : mLengthNone;
+    }
+}
+
+uint32_t Pathfinder::Search(const uint32_t start, const uint32_t goal, const uint32_t cluster, vector<uint32_t>* path) {
+    auto& scratch = mScratchTiles;
+    auto& open = scratch.open;
+
+    scratch.Reset(mWalkable.size());
+    scratch.Visit(start, 0, start);
+    open.push_back({ GetDistance(start, goal), start });
+
+    while (!open.empty()) {
+        pop_heap(open.begin(), open.end(), greater<>());
+        const auto [estimate, index] = open.back();
+        open.pop_back();
+
+        const auto length = scratch.lengths[index];
+        // a shorter way here was found after this one was queued
+        if (estimate > length + GetDistance(index, goal)) {
+            continue;
+        }
+
+        if (index == goal) {
+            if (path) {
+                for (auto i = goal; i != start; i = scratch.parents[i]) {
+                    path->push_back(i);
+                }
+            }
+
+            return length;
+        }
+
+        const auto x = (int32_t)(index % mWidth);
+        const auto y = (int32_t)(index / mWidth);
+
+        const pair<bool, uint32_t> neighbours[] = {
+            { x > 0, index - 1 },
+            { x + 1 < mWidth, index + 1 },
+            { y > 0, index - (uint32_t)mWidth },
+            { y + 1 < mHeight, index + (uint32_t)mWidth }
+        };
+
+        for (const auto& [isInside, neighbour] : neighbours) {
+            if (!isInside || !mWalkable[neighbour] || (cluster != mLengthNone && mClusters[neighbour] != cluster)) {
+                continue;
+            }
+
+            if (scratch.IsVisited(neighbour) && scratch.lengths[neighbour] <= length + 1) {
+                continue;
+            }
+
+            scratch.Visit(neighbour, length + 1, index);
+            open.push_back({ length + 1 + GetDistance(neighbour, goal), neighbour });
+            push_heap(open.begin(), open.end(), greater<>());
+        }
+    }
+
+    return mLengthNone;
+}
+
+uint32_t Pathfinder::SearchRoute(const uint32_t start, const uint32_t goal, Route& route) {
+    const auto clusterStart = mClusters[start];
+    const auto clusterGoal = mClusters[goal];
+
+    // a short trip inside one cluster never needs the abstract graph
+    if (clusterStart == clusterGoal) {
+        const auto length = Search(start, goal, clusterStart, nullptr);
+        if (length != mLengthNone) {
+            route.waypoints = { GetTile(start), GetTile(goal) };
+            route.length = length;
+
+            return length;
+        }
+    }
+
+    // start and goal join the graph for this query only, as the two nodes after the real ones
+    GetLengthsToNodes(start, mLengthsStart);
+    GetLengthsToNodes(goal, mLengthsGoal);
+
+    const auto nodeStart = (uint32_t)mNodes.size();
+    const auto nodeGoal = nodeStart + 1;
+    const auto getTile = [&](const uint32_t node) {
+        return node == nodeStart ? start : node == nodeGoal ? goal : mNodes[node].tile;
+    };
+
+    auto& scratch = mScratchNodes;
+    auto& open = scratch.open;
+
+    scratch.Reset(mNodes.size() + 2);
+    scratch.Visit(nodeStart, 0, nodeStart);
+    open.push_back({ GetDistance(start, goal), nodeStart });
+
+    const auto relax = [&](const uint32_t node, const uint32_t neighbour, const uint32_t length) {
+        if (scratch.IsVisited(neighbour) && scratch.lengths[neighbour] <= length) {
+            return;
+        }
+
+        scratch.Visit(neighbour, length, node);
+        open.push_back({ length + GetDistance(getTile(neighbour), goal), neighbour });
+        push_heap(open.begin(), open.end(), greater<>());
+    };
+
+    while (!open.empty()) {
+        pop_heap(open.begin(), open.end(), greater<>());
+        const auto [estimate, node] = open.back();
+        open.pop_back();
+
+        const auto length = scratch.lengths[node];
+        if (estimate > length + GetDistance(getTile(node), goal)) {
+            continue;
+        }
+
+        if (node == nodeGoal) {
+            mPath.clear();
+            for (auto i = nodeGoal; i != nodeStart; i = scratch.parents[i]) {
+                mPath.push_back(getTile(i));
+            }
+            mPath.push_back(start);
+
+            route.waypoints.clear();
+            for (auto index = mPath.rbegin(); index != mPath.rend(); index++) {
+                route.waypoints.push_back(GetTile(*index));
+            }
+            route.length = length;
+
+            return length;
+        }
+
+        if (node == nodeStart) {
+            const auto& nodes = mClusterNodes[clusterStart];
+            for (size_t i = 0; i < nodes.size(); i++) {
+                if (mLengthsStart[i] != mLengthNone) {
+                    relax(node, nodes[i], mLengthsStart[i]);
+                }
+            }
+
+            continue;
+        }
+
+        for (const auto& edge : mNodes[node].edges) {
+            relax(node, edge.node, length + edge.length);
+        }
+
+        if (mNodes[node].cluster == clusterGoal && mLengthsGoal[mNodes[node].slot] != mLengthNone) {
+            relax(node, nodeGoal, length + mLengthsGoal[mNodes[node].slot]);
+        }
+    }
+
+    return mLengthNone;
+}
+
+uint32_t Pathfinder::GetIndex(const Tile& tile) const {
+    return (uint32_t)((size_t)tile.GetY() * mWidth + tile.GetX());
+}
+
+Pathfinder::Tile Pathfinder::GetTile(const uint32_t index) const {
+    return { (int32_t)(index % mWidth), (int32_t)(index / mWidth) };
+}
+
+uint32_t Pathfinder::GetDistance(const uint32_t one, const uint32_t two) const {
+    const auto x = abs((int32_t)(one % mWidth) - (int32_t)(two % mWidth));
+    const auto y = abs((int32_t)(one / mWidth) - (int32_t)(two / mWidth));
+
+    return (uint32_t)(x + y);
+}
+
+uint64_t Pathfinder::GetKey(const uint32_t one, const uint32_t two) {
+    return ((uint64_t)one << 32) | two;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "Dungeon.h"
+
+#include <list>
+#include <unordered_map>
+
+// Finds paths over the walkable tiles of a dungeon on two levels. The cells of the BSP leaves
+// are the clusters: every run of walkable tiles crossing the border of two cells, which is where
+// the corridors from GeneratePath leave one room's cell for the next, becomes an entrance, and
+// the entrances of a cluster are linked by the lengths of the paths between them inside it.
+// A query searches that small graph for a route of waypoints, and a segment of the route is only
+// turned into tiles, by a search that never leaves its cluster, once an agent gets to it.
+// Queries reuse the scratch buffers and the caches, so one pathfinder serves one thread.
+class Pathfinder {
+public:
+    // tiles in the tile matrix of the dungeon, x to the right and y down, moving on 4 neighbours
+    using Tile = Point<int32_t>;
+
+    // the waypoints of a path, start first and goal last, with consecutive waypoints in one cluster
+    // or on both sides of an entrance
+    struct Route {
+        vector<Tile> waypoints {};
+        uint32_t length {};
+    };
+
+    struct Statistics {
+        size_t routes {};
+        size_t routesCached {};
+        size_t segments {};
+        size_t segmentsCached {};
+    };
+
+    static constexpr uint32_t mLengthNone = numeric_limits<uint32_t>::max();
+
+    Pathfinder(const Dungeon& dungeon, const size_t cacheCapacity = 1024);
+
+    bool IsWalkable(const Tile& tile) const;
+
+    // false when goal can not be reached from start
+    bool FindRoute(const Tile& start, const Tile& goal, Route& route);
+
+    // appends the tiles after waypoint segment up to and including waypoint segment + 1
+    bool Refine(const Route& route, const size_t segment, vector<Tile>& tiles);
+
+    // the route refined at once, start first
+    bool FindPath(const Tile& start, const Tile& goal, vector<Tile>& tiles);
+
+    // plain A* over the whole tile matrix, the baseline the hierarchy is measured against
+    bool FindPathFlat(const Tile& start, const Tile& goal, vector<Tile>& tiles);
+
+    size_t GetClusterCount() const;
+
+    size_t GetEntranceCount() const;
+
+    const Statistics& GetStatistics() const;
+
+    void ClearCache();
+
+private:
+    struct Edge {
+        uint32_t node {};
+        uint32_t length {};
+    };
+
+    // an abstract node sits on a tile next to the border of its cluster
+    struct Node {
+        uint32_t tile {};
+        uint32_t cluster {};
+        // where the node is in the list of its cluster
+        uint32_t slot {};
+        vector<Edge> edges {};
+    };
+
+    struct Entry {
+        uint64_t key {};
+        Route route {};
+    };
+
+    // for the searches on either level, a slot only counts when its stamp is the current one
+    struct Scratch {
+        vector<uint32_t> lengths {};
+        vector<uint32_t> parents {};
+        vector<uint32_t> stamps {};
+        uint32_t stamp {};
+
+        vector<pair<uint32_t, uint32_t>> open {};
+
+        void Reset(const size_t size);
+        bool IsVisited(const uint32_t index) const;
+        void Visit(const uint32_t index, const uint32_t length, const uint32_t parent);
+    };
+
+    void BuildClusters(const Dungeon& dungeon);
+    void BuildEntrances();
+    void AddEntrance(const uint32_t tileOne, const uint32_t tileTwo);
+    uint32_t AddNode(const uint32_t tile);
+    void BuildEdges();
+
+    // lengths from tile to every node of its cluster, mLengthNone where they are not connected
+    void GetLengthsToNodes(const uint32_t tile, vector<uint32_t>& lengths);
+
+    // A* from start to goal, inside cluster unless it is mLengthNone, the path goes in reverse
+    uint32_t Search(const uint32_t start, const uint32_t goal, const uint32_t cluster, vector<uint32_t>* path);
+    uint32_t SearchRoute(const uint32_t start, const uint32_t goal, Route& route);
+
+    uint32_t GetIndex(const Tile& tile) const;
+    Tile GetTile(const uint32_t index) const;
+    uint32_t GetDistance(const uint32_t one, const uint32_t two) const;
+
+    static uint64_t GetKey(const uint32_t one, const uint32_t two);
+
+    int32_t mWidth {};
+    int32_t mHeight {};
+    vector<uint8_t> mWalkable {};
+
+    // per tile, mLengthNone outside every leaf
+    vector<uint32_t> mClusters {};
+    vector<vector<uint32_t>> mClusterNodes {};
+
+    vector<Node> mNodes {};
+    unordered_map<uint32_t, uint32_t> mNodeAt {};
+    size_t mEntrances {};
+
+    Scratch mScratchTiles {};
+    Scratch mScratchNodes {};
+    vector<uint32_t> mLengthsStart {};
+    vector<uint32_t> mLengthsGoal {};
+    vector<uint32_t> mPath {};
+
+    // routes by start and goal, least recently used last
+    size_t mCacheCapacity {};
+    list<Entry> mRoutes {};
+    unordered_map<uint64_t, list<Entry>::iterator> mRoutesIndex {};
+    // segments between two waypoints, dropped all at once when they outgrow the capacity
+    unordered_map<uint64_t, vector<uint32_t>> mSegments {};
+
+    Statistics mStatistics {};
+};
\ No newline at end of file
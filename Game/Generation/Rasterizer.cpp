@@ -0,0 +1,30 @@
+#include "Game/pch.h"
+#include "Rasterizer.h"
+
+Rasterizer::Rasterizer(const size_t threads /* = 1 */, const size_t bandHeight /* = 64 */)
+    : mThreads(threads), mBandHeight(max<size_t>(bandHeight, 1)) {}
+
+void Rasterizer::Clear() {
+    mShapes.clear();
+}
+
+void Rasterizer::Reserve(const size_t count) {
+    mShapes.reserve(count);
+}
+
+void Rasterizer::Add(const size_t x, const size_t y, const size_t w, const size_t h, const uint8_t layer) {
+    mShapes.push_back({ (uint32_t)x, (uint32_t)y, (uint32_t)w, (uint32_t)h, layer });
+}
+
+size_t Rasterizer::GetThreads() const {
+    return mThreads;
+}
+
+ThreadPool& Rasterizer::GetThreadPool() {
+    // the calling thread paints bands too
+    if (!mThreadPool) {
+        mThreadPool = make_unique<ThreadPool>(mThreads - 1);
+    }
+
+    return *mThreadPool;
+}
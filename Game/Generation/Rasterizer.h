@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Engine/Utility/ThreadPool.h"
+
+// Paints axis-aligned rectangles, given in tiles, into a tile grid where later rectangles
+// cover earlier ones. Large grids are cut into horizontal bands of whole rows, every band
+// gets the rectangles clipped to it and is painted by its own worker, so no two threads
+// ever write the same row.
+class Rasterizer {
+public:
+    Rasterizer(const size_t threads = 1, const size_t bandHeight = 64);
+
+    void Clear();
+
+    void Reserve(const size_t count);
+
+    // layer picks the value painted from the array handed to Rasterize
+    void Add(const size_t x, const size_t y, const size_t w, const size_t h, const uint8_t layer);
+
+    template<typename Grid, typename Value>
+    void Rasterize(Grid& grid, const Value* values) {
+        const auto height = grid.GetHeight();
+        const auto bands = (height + mBandHeight - 1) / mBandHeight;
+
+        if (mThreads <= 1 || bands <= 1) {
+            for (const auto& shape : mShapes) {
+                Paint(grid, shape, values[shape.layer], 0, height);
+            }
+
+            return;
+        }
+
+        // shapes are bucketed in order, so every band still paints them back to front
+        vector<vector<uint32_t>> buckets(bands);
+        for (uint32_t i = 0; i < (uint32_t)mShapes.size(); i++) {
+            const auto& shape = mShapes[i];
+            if (!shape.w || !shape.h || shape.y >= height) {
+                continue;
+            }
+
+            const auto bandLast = min<size_t>((size_t)shape.y + shape.h - 1, height - 1) / mBandHeight;
+            for (size_t band = shape.y / mBandHeight; band <= bandLast; band++) {
+                buckets[band].push_back(i);
+            }
+        }
+
+        GetThreadPool().ForEach(bands, [&](const size_t band) {
+            const auto first = band * mBandHeight;
+            const auto last = min(first + mBandHeight, height);
+
+            for (const auto i : buckets[band]) {
+                const auto& shape = mShapes[i];
+                Paint(grid, shape, values[shape.layer], first, last);
+            }
+        });
+    }
+
+    size_t GetThreads() const;
+
+private:
+    struct Shape {
+        uint32_t x {};
+        uint32_t y {};
+        uint32_t w {};
+        uint32_t h {};
+        uint8_t layer {};
+    };
+
+    template<typename Grid, typename Value>
+    static void Paint(Grid& grid, const Shape& shape, const Value& value, const size_t rowFirst, const size_t rowLast) {
+        const auto first = max<size_t>(shape.y, rowFirst);
+        const auto last = min<size_t>((size_t)shape.y + shape.h, rowLast);
+
+        for (auto y = first; y < last; y++) {
+            grid.FillRow(shape.x, y, shape.w, value);
+        }
+    }
+
+    ThreadPool& GetThreadPool();
+
+    vector<Shape> mShapes {};
+
+    size_t mThreads {};
+    size_t mBandHeight {};
+    unique_ptr<ThreadPool> mThreadPool {};
+};
\ No newline at end of file
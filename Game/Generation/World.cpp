@@ -0,0 +1,168 @@
+#include "Game/pch.h"
+#include "Engine/Utility/Profiler.h"
+#include "World.h"
+
+World::World(
+    const uint64_t seed,
+    const Point<float>& chunkSize,
+    const size_t iterations,
+    const float tileSize /* = 5.f */,
+    const size_t capacity /* = 64 */,
+    const size_t threads /* = 1 */,
+    const Point<float>& ratioToDiscard /* = { 0.45f, 0.45f } */
+)
+    : mSeed(seed),
+    mChunkSize(chunkSize),
+    mIterations(iterations),
+    mTileSize(tileSize),
+    mRatioToDiscard(ratioToDiscard),
+    mThreads(threads),
+    mCapacity(max<size_t>(capacity, 1)) {}
+
+Dungeon& World::GetChunk(const Point<int32_t>& chunk) {
+    auto& dungeon = *Touch(chunk).dungeon;
+    Trim(1);
+
+    return dungeon;
+}
+
+void World::GetChunks(const Rectangle<float>& area, vector<pair<Point<int32_t>, Dungeon*>>& chunks) {
+    chunks.clear();
+
+    const auto first = GetChunkAt({ area.GetX(), area.GetY() });
+    const auto last = Point<int32_t>(
+        max(first.GetX(), (int32_t)ceil((area.GetX() + area.GetW()) / mChunkSize.GetX()) - 1),
+        max(first.GetY(), (int32_t)ceil((area.GetY() + area.GetH()) / mChunkSize.GetY()) - 1)
+    );
+
+    mMissing.clear();
+    for (auto y = first.GetY(); y <= last.GetY(); y++) {
+        for (auto x = first.GetX(); x <= last.GetX(); x++) {
+            if (!mIndex.count(GetKey({ x, y }))) {
+                mMissing.push_back({ x, y });
+            }
+        }
+    }
+
+    Generate(mMissing);
+
+    for (auto y = first.GetY(); y <= last.GetY(); y++) {
+        for (auto x = first.GetX(); x <= last.GetX(); x++) {
+            chunks.push_back({ { x, y }, Touch({ x, y }).dungeon.get() });
+        }
+    }
+
+    Trim(chunks.size());
+}
+
+Point<int32_t> World::GetChunkAt(const Point<float>& position) const {
+    return { (int32_t)floor(position.GetX() / mChunkSize.GetX()),
+             (int32_t)floor(position.GetY() / mChunkSize.GetY()) };
+}
+
+Point<float> World::GetChunkOrigin(const Point<int32_t>& chunk) const {
+    return { (float)chunk.GetX() * mChunkSize.GetX(),
+             (float)chunk.GetY() * mChunkSize.GetY() };
+}
+
+uint64_t World::GetChunkSeed(const Point<int32_t>& chunk) const {
+    return RandomCounter(mSeed).Split(GetKey(chunk))();
+}
+
+const Point<float>& World::GetChunkSize() const {
+    return mChunkSize;
+}
+
+size_t World::GetSize() const {
+    return mChunks.size();
+}
+
+size_t World::GetCapacity() const {
+    return mCapacity;
+}
+
+void World::SetCapacity(const size_t capacity) {
+    mCapacity = max<size_t>(capacity, 1);
+    Trim(0);
+}
+
+size_t World::GetGenerated() const {
+    return mGenerated;
+}
+
+size_t World::GetEvicted() const {
+    return mEvicted;
+}
+
+uint64_t World::GetSeed() const {
+    return mSeed;
+}
+
+uint64_t World::GetKey(const Point<int32_t>& chunk) {
+    return ((uint64_t)(uint32_t)chunk.GetX() << 32) | (uint32_t)chunk.GetY();
+}
+
+unique_ptr<Dungeon> World::GenerateChunk(const Point<int32_t>& chunk) const {
+    PROFILE_SCOPE("World::GenerateChunk");
+
+    return make_unique<Dungeon>(mIterations, mChunkSize, mTileSize, mRatioToDiscard, GetChunkSeed(chunk));
+}
+
+void World::Generate(const vector<Point<int32_t>>& chunks) {
+    PROFILE_SCOPE("World::Generate");
+
+    if (mThreads <= 1 || chunks.size() <= 1) {
+        for (const auto& chunk : chunks) {
+            Touch(chunk);
+        }
+
+        return;
+    }
+
+    vector<unique_ptr<Dungeon>> dungeons(chunks.size());
+    GetThreadPool().ForEach(chunks.size(), [&](const size_t i) {
+        dungeons[i] = GenerateChunk(chunks[i]);
+    });
+
+    for (size_t i = 0; i < chunks.size(); i++) {
+        mChunks.push_front({ chunks[i], move(dungeons[i]) });
+        mIndex[GetKey(chunks[i])] = mChunks.begin();
+    }
+
+    mGenerated += chunks.size();
+}
+
+World::Chunk& World::Touch(const Point<int32_t>& chunk) {
+    const auto key = GetKey(chunk);
+
+    const auto it = mIndex.find(key);
+    if (it != mIndex.end()) {
+        mChunks.splice(mChunks.begin(), mChunks, it->second);
+        return mChunks.front();
+    }
+
+    mChunks.push_front({ chunk, GenerateChunk(chunk) });
+    mIndex[key] = mChunks.begin();
+    mGenerated++;
+
+    return mChunks.front();
+}
+
+ThreadPool& World::GetThreadPool() {
+    // the calling thread generates chunks too
+    if (!mThreadPool) {
+        mThreadPool = make_unique<ThreadPool>(mThreads - 1);
+    }
+
+    return *mThreadPool;
+}
+
+void World::Trim(const size_t keep) {
+    const auto size = max(mCapacity, keep);
+
+    while (mChunks.size() > size) {
+        mIndex.erase(GetKey(mChunks.back().coordinates));
+        mChunks.pop_back();
+        mEvicted++;
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Dungeon.h"
+
+#include "Engine/Utility/ThreadPool.h"
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+// An unbounded dungeon cut into chunks of the same size. Every chunk is a Dungeon seeded from
+// the world seed and its coordinates, so a chunk always comes back the same after being evicted.
+// Chunks are generated the first time a query touches them and kept in an LRU cache that never
+// holds more than the capacity, except while a single query needs more chunks than that.
+class World {
+public:
+    World(
+        const uint64_t seed,
+        const Point<float>& chunkSize,
+        const size_t iterations,
+        const float tileSize = 5.f,
+        const size_t capacity = 64,
+        const size_t threads = 1,
+        const Point<float>& ratioToDiscard = { 0.45f, 0.45f }
+    );
+
+    Dungeon& GetChunk(const Point<int32_t>& chunk);
+
+    // Fills chunks with every chunk overlapping area, in world coordinates, row by row.
+    // The pointers stay valid until the next call that can generate chunks.
+    void GetChunks(const Rectangle<float>& area, vector<pair<Point<int32_t>, Dungeon*>>& chunks);
+
+    Point<int32_t> GetChunkAt(const Point<float>& position) const;
+
+    Point<float> GetChunkOrigin(const Point<int32_t>& chunk) const;
+
+    uint64_t GetChunkSeed(const Point<int32_t>& chunk) const;
+
+    const Point<float>& GetChunkSize() const;
+
+    size_t GetSize() const;
+
+    size_t GetCapacity() const;
+
+    void SetCapacity(const size_t capacity);
+
+    size_t GetGenerated() const;
+
+    size_t GetEvicted() const;
+
+    uint64_t GetSeed() const;
+
+private:
+    struct Chunk {
+        Point<int32_t> coordinates {};
+        unique_ptr<Dungeon> dungeon {};
+    };
+
+    static uint64_t GetKey(const Point<int32_t>& chunk);
+
+    unique_ptr<Dungeon> GenerateChunk(const Point<int32_t>& chunk) const;
+
+    // generates the missing chunks among the given ones, several at once when threads allow it
+    void Generate(const vector<Point<int32_t>>& chunks);
+
+    // moves the chunk to the front, generating it when it is missing
+    Chunk& Touch(const Point<int32_t>& chunk);
+
+    ThreadPool& GetThreadPool();
+
+    // evicts from the back, but never the first keep chunks
+    void Trim(const size_t keep);
+
+    uint64_t mSeed {};
+    Point<float> mChunkSize {};
+    size_t mIterations {};
+    float mTileSize {};
+    Point<float> mRatioToDiscard {};
+    size_t mThreads {};
+
+    size_t mCapacity {};
+    size_t mGenerated {};
+    size_t mEvicted {};
+
+    // most recently used first
+    list<Chunk> mChunks {};
+    unordered_map<uint64_t, list<Chunk>::iterator> mIndex {};
+
+    unique_ptr<ThreadPool> mThreadPool {};
+
+    vector<Point<int32_t>> mMissing {};
+};
\ No newline at end of file
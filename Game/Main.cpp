@@ -2,10 +2,14 @@
 
 #include "Engine/Core/Window.h"
 #include "Engine/Core/ManagerTexture.h"
+#include "Engine/Core/Loop.h"
 
 #include "Engine/Utility/Miscellaneous.h"
+#include "Engine/Utility/ManagerFile.h"
+#include "Engine/Utility/Profiler.h"
 
-#include "Generation/Dungeon.h"
+#include "Render/CacheChunk.h"
+#include "Render/RendererTileMatrix.h"
 
 #define WINDOW_WIDTH_START (640)
 #define WINDOW_HEIGHT_START (480)
@@ -18,6 +22,18 @@
 
 #define TILE_SIZE (10.f)
 
+#define LOOP_TIMESTEP (1. / 60.)
+
+#define TEXTURE_MANIFEST ("Assets/Textures.txt")
+#define TEXTURE_ATLAS ("Assets/Tiles.atlas")
+#define TEXTURE_WALL ("Assets/wall.png")
+#define TEXTURE_UPLOAD_BUDGET (0.002)
+
+#define CHUNK_ITERATIONS (4)
+#define CHUNK_CACHE_CAPACITY (64)
+
+#define PROFILER_TRACE ("Trace.json")
+
 Point<float> translation {};
 
 void ScreenToObject(Point<float>& mousePos, const float zoom) {
@@ -30,6 +46,22 @@ void ObjectToScreen(Point<float>& mousePos, const float zoom) {
     mousePos.SetY(translation.GetY() + (mousePos.GetY() * zoom));
 }
 
+// P starts recording, pressing it again writes the trace and logs the frame times
+void ToggleProfiler() {
+    if (!profiler.IsRecording()) {
+        profiler.Clear();
+        profiler.SetRecording(true);
+        return;
+    }
+
+    profiler.SetRecording(false);
+    LOG_AND_RETURN_IF(!profiler.Export(PROFILER_TRACE), "Failed to write the trace \"" + string(PROFILER_TRACE) + "\"!", LOG_TYPE_WARNING, );
+
+    const auto frames = profiler.GetFrameStatistics();
+    LOG("Frames " + to_string(frames.frames) + ": min " + to_string(frames.min) + " ms, average " + to_string(frames.average) +
+        " ms, p99 " + to_string(frames.p99) + " ms, trace in \"" + PROFILER_TRACE + "\"\n", LOG_TYPE_INFO);
+}
+
 int main(int /*argc*/, char** /*argv*/) {
     Window window(
         "Dangian",
@@ -38,18 +70,49 @@ int main(int /*argc*/, char** /*argv*/) {
         WINDOW_FLAGS, RENDERER_FLAGS
     );
 
-    Dungeon dungeon(4, { WINDOW_WIDTH_START, WINDOW_HEIGHT_START }, TILE_SIZE);
+    // the textures decode on other threads while the first chunks generate
+    ManagerTexture managerTexture;
+    vector<ManagerTexture::Handle> textures {};
+    managerTexture.Preload(TEXTURE_MANIFEST, textures);
+
+    // the atlas is baked by the Atlas tool, the loose image stands in for it until it is
+    ManagerTexture::Region regionWall {};
+    if (!ManagerFile::Exists(TEXTURE_ATLAS) || !managerTexture.LoadAtlas(TEXTURE_ATLAS) ||
+        !managerTexture.GetRegion("wall", regionWall)) {
+        regionWall = { managerTexture.LoadAsync(TEXTURE_WALL) };
+    }
+
+    World world(
+        random_device {}(),
+        { WINDOW_WIDTH_START, WINDOW_HEIGHT_START },
+        CHUNK_ITERATIONS,
+        TILE_SIZE,
+        CHUNK_CACHE_CAPACITY,
+        thread::hardware_concurrency()
+    );
+
+    RendererDungeon rendererDungeon(window.GetRenderer());
+    CacheChunk cacheChunk(rendererDungeon, CHUNK_CACHE_CAPACITY);
+
+    // T switches between the flat rectangles and the textured tiles
+    RendererTileMatrix rendererTileMatrix(window.GetRenderer());
+    bool isTextured = false;
 
-    vector<vector<Dungeon::Tile>> tileMatrix;
-    dungeon.GenerateTileMatrix(tileMatrix);
+    Matrix<Dungeon::Tile> tileMatrix;
+    world.GetChunk({ 0, 0 }).GenerateTileMatrix(tileMatrix);
 
-    for (size_t i = 0; i < tileMatrix.size(); i++) {
-        for (size_t j = 0; j < tileMatrix[0].size(); j++) {
-            logger << (int)tileMatrix[i][j] << " ";
+    // one record per row instead of one per tile
+    string row {};
+    for (size_t i = 0; i < tileMatrix.GetHeight(); i++) {
+        row.clear();
+        for (size_t j = 0; j < tileMatrix.GetWidth(); j++) {
+            row += to_string((int)tileMatrix[i][j]) + ' ';
         }
-        logger << "\n";
+        logger << row << "\n";
     }
 
+    // the loop only draws after something changed and sleeps on the events in between
+    Loop loop(LOOP_TIMESTEP);
     bool isRunning = true;
     SDL_Event event {};
 
@@ -60,104 +123,199 @@ int main(int /*argc*/, char** /*argv*/) {
     Point<float> offsetMapLast {};
     Point<float> offsetMapCurrent {};
 
+    string titleLast {};
+
     float zoomCurrent = 1.f;
     float zoomScale = 0.05f;
     bool zoomed = false;
 
     while (isRunning) {
-        while (SDL_PollEvent(&event)) {
-            switch (event.type) {
-                case SDL_QUIT:
-                    isRunning = false;
-                    break;
-
-                case SDL_MOUSEBUTTONDOWN:
-                    {
-                        if (zoomed) {
-                            offsetMapLast = offsetMapCurrent;
-                            translation = {};
-
-                            zoomed = false;
+        loop.BeginFrame();
+
+        {
+            PROFILE_SCOPE("Main::Events");
+
+            while (loop.PollEvent(event)) {
+                switch (event.type) {
+                    case SDL_QUIT:
+                        isRunning = false;
+                        break;
+
+                    case SDL_WINDOWEVENT:
+                        // resized, exposed or restored, none of them keeps the old picture
+                        loop.Invalidate();
+                        break;
+
+                    case SDL_RENDER_TARGETS_RESET:
+                    case SDL_RENDER_DEVICE_RESET:
+                        // the cached chunks lost their pixels, so they are drawn again from scratch
+                        cacheChunk.Clear();
+                        loop.Invalidate();
+                        break;
+
+                    case SDL_KEYDOWN:
+                        if (event.key.keysym.sym == SDLK_t) {
+                            isTextured = !isTextured;
+                            loop.Invalidate();
+                        } else if (event.key.keysym.sym == SDLK_p) {
+                            ToggleProfiler();
                         }
 
-                        isMouseButtonDown = true;
-                        SDL_GetMouseState(&mousePosOnButtonDown.x, &mousePosOnButtonDown.y);
-                    }
+                        break;
 
-                    break;
+                    case SDL_MOUSEBUTTONDOWN:
+                        {
+                            if (zoomed) {
+                                offsetMapLast = offsetMapCurrent;
+                                translation = {};
 
-                case SDL_MOUSEMOTION:
-                    if (isMouseButtonDown) {
-                        SDL_Point mousePosCurrent {};
-                        SDL_GetMouseState(&mousePosCurrent.x, &mousePosCurrent.y);
+                                zoomed = false;
+                            }
 
-                        mousePosDiff = { -(float)(mousePosOnButtonDown.x - mousePosCurrent.x),
-                                         -(float)(mousePosOnButtonDown.y - mousePosCurrent.y) };
+                            isMouseButtonDown = true;
+                            SDL_GetMouseState(&mousePosOnButtonDown.x, &mousePosOnButtonDown.y);
+                        }
+
+                        break;
 
-                        const float zoomCurrentInverted = 1.f / zoomCurrent;
-                        offsetMapCurrent = offsetMapLast + mousePosDiff * zoomCurrentInverted;
-                    }
+                    case SDL_MOUSEMOTION:
+                        if (isMouseButtonDown) {
+                            SDL_Point mousePosCurrent {};
+                            SDL_GetMouseState(&mousePosCurrent.x, &mousePosCurrent.y);
 
-                    break;
+                            mousePosDiff = { -(float)(mousePosOnButtonDown.x - mousePosCurrent.x),
+                                             -(float)(mousePosOnButtonDown.y - mousePosCurrent.y) };
 
-                case SDL_MOUSEBUTTONUP:
-                    {
-                        isMouseButtonDown = false;
-                        offsetMapLast = offsetMapCurrent;
-                    }
+                            const float zoomCurrentInverted = 1.f / zoomCurrent;
+                            offsetMapCurrent = offsetMapLast + mousePosDiff * zoomCurrentInverted;
+                            loop.Invalidate();
+                        }
 
-                    break;
+                        break;
 
-                case SDL_MOUSEWHEEL:
-                    {
-                        int zoomType = 0;
-                        if (event.wheel.y > 0 && zoomCurrent <= ZOOM_MAX) {
-                            zoomType = 1;
-                        } else if (event.wheel.y < 0 && zoomCurrent >= ZOOM_MIN) {
-                            zoomType = -1;
+                    case SDL_MOUSEBUTTONUP:
+                        {
+                            isMouseButtonDown = false;
+                            offsetMapLast = offsetMapCurrent;
                         }
 
-                        if (zoomType) {
-                            zoomed = zoomType;
+                        break;
 
-                            SDL_Point mousePosCurrent {};
-                            SDL_GetMouseState(&mousePosCurrent.x, &mousePosCurrent.y);
-                            Point<float> mousePos { (float)mousePosCurrent.x, (float)mousePosCurrent.y };
+                    case SDL_MOUSEWHEEL:
+                        {
+                            int zoomType = 0;
+                            if (event.wheel.y > 0 && zoomCurrent <= ZOOM_MAX) {
+                                zoomType = 1;
+                            } else if (event.wheel.y < 0 && zoomCurrent >= ZOOM_MIN) {
+                                zoomType = -1;
+                            }
+
+                            if (zoomType) {
+                                zoomed = zoomType;
 
-                            ScreenToObject(mousePos, zoomCurrent);
-                            zoomCurrent += zoomScale * zoomType;
-                            ObjectToScreen(mousePos, zoomCurrent);
+                                SDL_Point mousePosCurrent {};
+                                SDL_GetMouseState(&mousePosCurrent.x, &mousePosCurrent.y);
+                                Point<float> mousePos { (float)mousePosCurrent.x, (float)mousePosCurrent.y };
 
-                            translation.SetX(translation.GetX() + ((float)mousePosCurrent.x - mousePos.GetX()));
-                            translation.SetY(translation.GetY() + ((float)mousePosCurrent.y - mousePos.GetY()));
+                                ScreenToObject(mousePos, zoomCurrent);
+                                zoomCurrent += zoomScale * zoomType;
+                                ObjectToScreen(mousePos, zoomCurrent);
 
-                            offsetMapCurrent = offsetMapLast + translation;
+                                translation.SetX(translation.GetX() + ((float)mousePosCurrent.x - mousePos.GetX()));
+                                translation.SetY(translation.GetY() + ((float)mousePosCurrent.y - mousePos.GetY()));
+
+                                offsetMapCurrent = offsetMapLast + translation;
+                                loop.Invalidate();
+                            }
                         }
-                    }
 
-                    break;
+                        break;
+                }
+            }
+        }
+
+        // the uploads are spread over the steps, a texture that arrives has to be shown
+        PROFILE_COUNTER("ManagerTexture::pending", managerTexture.GetPending());
+        while (loop.Update()) {
+            if (managerTexture.Upload(window.GetRenderer(), TEXTURE_UPLOAD_BUDGET)) {
+                loop.Invalidate();
             }
         }
 
+        // the steps only come while frames do, so the loop is kept awake until every texture is in
+        if (managerTexture.GetPending()) {
+            loop.Invalidate();
+        }
+
+        if (!loop.ShouldRender()) {
+            loop.EndFrame();
+            continue;
+        }
+
+        // looking a handle up is an array read, so the textures are simply set again every frame
+        const auto textureWall = managerTexture.GetTexture(regionWall.texture);
+        const auto coordinatesWall = managerTexture.GetCoordinates(regionWall);
+        rendererTileMatrix.SetTexture(Dungeon::Tile::ROOM, textureWall, { 255, 255, 255, SDL_ALPHA_OPAQUE }, coordinatesWall);
+        rendererTileMatrix.SetTexture(Dungeon::Tile::PATH, textureWall, { 160, 160, 160, SDL_ALPHA_OPAQUE }, coordinatesWall);
+
         SDL_SetRenderDrawColor(window.GetRenderer(), 0, 0, 0, SDL_ALPHA_OPAQUE);
         SDL_RenderClear(window.GetRenderer());
         SDL_SetRenderDrawColor(window.GetRenderer(), 255, 255, 255, SDL_ALPHA_OPAQUE);
 
-        dungeon.Render(
-            window.GetRenderer(),
-            { zoomCurrent, zoomCurrent },
-            offsetMapCurrent
-        );
+        SDL_Point viewport {};
+        SDL_GetRendererOutputSize(window.GetRenderer(), &viewport.x, &viewport.y);
 
-        SDL_RenderPresent(window.GetRenderer());
+        const Point<float> viewportSize { (float)viewport.x, (float)viewport.y };
+        string title {};
+
+        if (isTextured) {
+            rendererTileMatrix.Render(world, viewportSize, { zoomCurrent, zoomCurrent }, offsetMapCurrent);
+
+            const auto& statistics = rendererTileMatrix.GetStatistics();
+            PROFILE_COUNTER("RendererTileMatrix::tiles", statistics.tiles);
+            PROFILE_COUNTER("RendererTileMatrix::batches", statistics.batches);
+
+            title = "Dangian - tiles " + to_string(statistics.tiles) + ", batches " + to_string(statistics.batches);
+        } else {
+            // panning only copies the cached chunks, the rooms are drawn again when the zoom bucket changes
+            rendererDungeon.ResetStatistics();
+            cacheChunk.Render(world, viewportSize, { zoomCurrent, zoomCurrent }, offsetMapCurrent);
+
+            const auto& statistics = rendererDungeon.GetStatistics();
+            const auto& statisticsCache = cacheChunk.GetStatistics();
+            PROFILE_COUNTER("RendererDungeon::drawn", statistics.drawn);
+            PROFILE_COUNTER("CacheChunk::rasterized", statisticsCache.rasterized);
+
+            title = "Dangian - drawn " + to_string(statistics.drawn) + ", culled " + to_string(statistics.culled) +
+                    ", blits " + to_string(statisticsCache.blits) + ", rasterized " + to_string(statisticsCache.rasterized);
+        }
+
+        // setting the title goes through the window system, so it is only done when it changes
+        if (title != titleLast) {
+            titleLast = title;
+            SDL_SetWindowTitle(window.GetWindow(), title.c_str());
+        }
+
+        {
+            PROFILE_SCOPE("Main::Present");
+            SDL_RenderPresent(window.GetRenderer());
+        }
+
+        loop.EndFrame();
+        PROFILE_FRAME();
     }
 
+    const auto& statistics = loop.GetStatistics();
+    const auto elapsed = max(statistics.idle + statistics.busy, 1e-9);
+    LOG("Frames " + to_string(statistics.frames) + ", rendered " + to_string(statistics.rendered) + ", updates " +
+        to_string(statistics.updates) + ", idle " + to_string((int)(statistics.idle / elapsed * 100.)) + "%, render interval " +
+        to_string(statistics.renderIntervalAverage) + " ms average, " + to_string(statistics.renderIntervalMax) + " ms max\n", LOG_TYPE_INFO);
+
     return EXIT_SUCCESS;
 }
 
 /*
     TO DO:
-            - make the alg iterative
             - check every shit because OCD...
             - add namespaces to keep the popular naming everywhere
             - The Engine needs more abstractization to stop using the sdl2 dependencies in the actual game
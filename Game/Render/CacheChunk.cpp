@@ -0,0 +1,157 @@
+#include "Game/pch.h"
+#include "Engine/Utility/Miscellaneous.h"
+#include "Engine/Utility/Profiler.h"
+#include "CacheChunk.h"
+
+CacheChunk::CacheChunk(
+    RendererDungeon& rendererDungeon,
+    const size_t capacity /* = 64 */,
+    const float zoomStep /* = 0.25f */
+)
+    : mRendererDungeon(rendererDungeon),
+    mCapacity(max<size_t>(capacity, 1)),
+    mZoomStep(zoomStep) {}
+
+CacheChunk::~CacheChunk() {
+    Clear();
+}
+
+void CacheChunk::Render(
+    World& world,
+    const Point<float>& viewport,
+    const Point<float>& scale /* = { 1.f, 1.f } */,
+    const Point<float>& offset /* = {} */
+) {
+    PROFILE_SCOPE("CacheChunk::Render");
+
+    mStatistics = {};
+
+    // every texture was drawn at the old bucket, stretching them further would only blur them
+    const auto zoomBucket = GetZoomBucket(max(scale.GetX(), scale.GetY()));
+    if (zoomBucket != mZoomBucket) {
+        Clear();
+        mZoomBucket = zoomBucket;
+    }
+
+    world.GetChunks(RendererDungeon::GetVisible(viewport, scale, offset), mChunks);
+
+    const auto& chunkSize = world.GetChunkSize();
+    for (const auto& [chunk, dungeon] : mChunks) {
+        const auto entry = Touch(chunk, *dungeon, chunkSize);
+        if (!entry) {
+            continue;
+        }
+
+        const auto origin = (world.GetChunkOrigin(chunk) + offset) * scale;
+        const SDL_FRect frect { origin.GetX(), origin.GetY(),
+                                chunkSize.GetX() * scale.GetX(), chunkSize.GetY() * scale.GetY() };
+
+        SDL_RenderCopyF(mRendererDungeon.GetRenderer(), entry->texture, nullptr, &frect);
+        mStatistics.blits++;
+    }
+
+    Trim(mChunks.size());
+}
+
+void CacheChunk::Clear() {
+    for (auto& entry : mEntries) {
+        SDL_DestroyTexture(entry.texture);
+    }
+
+    mEntries.clear();
+    mIndex.clear();
+}
+
+float CacheChunk::GetZoomBucket(const float zoom) const {
+    return max(mZoomStep, ceil(zoom / mZoomStep) * mZoomStep);
+}
+
+size_t CacheChunk::GetSize() const {
+    return mEntries.size();
+}
+
+size_t CacheChunk::GetCapacity() const {
+    return mCapacity;
+}
+
+const CacheChunk::Statistics& CacheChunk::GetStatistics() const {
+    return mStatistics;
+}
+
+uint64_t CacheChunk::GetKey(const Point<int32_t>& chunk) {
+    return ((uint64_t)(uint32_t)chunk.GetX() << 32) | (uint32_t)chunk.GetY();
+}
+
+CacheChunk::Entry* CacheChunk::Touch(const Point<int32_t>& chunk, const Dungeon& dungeon, const Point<float>& chunkSize) {
+    const auto key = GetKey(chunk);
+
+    auto iterator = mIndex.find(key);
+    if (iterator == mIndex.end()) {
+        mEntries.push_front({ chunk });
+        iterator = mIndex.emplace(key, mEntries.begin()).first;
+    } else {
+        mEntries.splice(mEntries.begin(), mEntries, iterator->second);
+    }
+
+    // the world may have evicted and generated the chunk again since it was drawn
+    auto& entry = mEntries.front();
+    const pair<const Dungeon*, uint64_t> dungeonKey { &dungeon, dungeon.GetSeed() };
+    if (!entry.texture || entry.dungeon != dungeonKey) {
+        entry.dungeon = dungeonKey;
+
+        if (!Rasterize(entry, dungeon, chunkSize)) {
+            return nullptr;
+        }
+    }
+
+    return &entry;
+}
+
+bool CacheChunk::Rasterize(Entry& entry, const Dungeon& dungeon, const Point<float>& chunkSize) {
+    PROFILE_SCOPE("CacheChunk::Rasterize");
+
+    const auto renderer = mRendererDungeon.GetRenderer();
+
+    if (!entry.texture) {
+        entry.texture = SDL_CreateTexture(
+            renderer,
+            SDL_PIXELFORMAT_RGBA32,
+            SDL_TEXTUREACCESS_TARGET,
+            (int)ceil(chunkSize.GetX() * mZoomBucket),
+            (int)ceil(chunkSize.GetY() * mZoomBucket)
+        );
+
+        if (!entry.texture) {
+            LOG(string("The chunk texture could not be created! Error: ") + SDL_GetError() + '.', LOG_TYPE_ERROR);
+            return false;
+        }
+
+        SDL_SetTextureBlendMode(entry.texture, SDL_BLENDMODE_BLEND);
+    }
+
+    const auto targetLast = SDL_GetRenderTarget(renderer);
+    SDL_Color colorLast {};
+    SDL_GetRenderDrawColor(renderer, &colorLast.r, &colorLast.g, &colorLast.b, &colorLast.a);
+
+    // transparent around the rooms, so whatever is behind the chunk shows through
+    SDL_SetRenderTarget(renderer, entry.texture);
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_TRANSPARENT);
+    SDL_RenderClear(renderer);
+    SDL_SetRenderDrawColor(renderer, colorLast.r, colorLast.g, colorLast.b, colorLast.a);
+
+    mRendererDungeon.Render(dungeon, { mZoomBucket, mZoomBucket });
+
+    SDL_SetRenderTarget(renderer, targetLast);
+
+    mStatistics.rasterized++;
+    return true;
+}
+
+void CacheChunk::Trim(const size_t keep) {
+    while (mEntries.size() > max(mCapacity, keep)) {
+        SDL_DestroyTexture(mEntries.back().texture);
+
+        mIndex.erase(GetKey(mEntries.back().coordinates));
+        mEntries.pop_back();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "RendererDungeon.h"
+
+#include <unordered_map>
+
+// Keeps every chunk of a world drawn once into a texture, so panning only copies textures
+// around. Chunks are drawn at the zoom rounded to a bucket and stretched to the exact zoom,
+// hence they are drawn again only when the bucket or the chunk itself changes.
+// The textures are render targets, whose contents the driver may drop on
+// SDL_RENDER_TARGETS_RESET or SDL_RENDER_DEVICE_RESET, the owner has to call Clear on both.
+class CacheChunk {
+public:
+    // what the last Render did
+    struct Statistics {
+        size_t blits {};
+        size_t rasterized {};
+    };
+
+    CacheChunk(RendererDungeon& rendererDungeon, const size_t capacity = 64, const float zoomStep = 0.25f);
+
+    ~CacheChunk();
+
+    CacheChunk(const CacheChunk&) = delete;
+
+    CacheChunk& operator=(const CacheChunk&) = delete;
+
+    // Same view as RendererDungeon::Render with a world, drawn from the cached textures
+    void Render(
+        World& world,
+        const Point<float>& viewport,
+        const Point<float>& scale = { 1.f, 1.f },
+        const Point<float>& offset = {}
+    );
+
+    // destroys every cached texture, the next Render draws the visible chunks again
+    void Clear();
+
+    float GetZoomBucket(const float zoom) const;
+
+    size_t GetSize() const;
+
+    size_t GetCapacity() const;
+
+    const Statistics& GetStatistics() const;
+
+private:
+    struct Entry {
+        Point<int32_t> coordinates {};
+        pair<const Dungeon*, uint64_t> dungeon {};
+        SDL_Texture* texture = nullptr;
+    };
+
+    static uint64_t GetKey(const Point<int32_t>& chunk);
+
+    // moves the entry to the front, drawing it again when it is missing or stale
+    Entry* Touch(const Point<int32_t>& chunk, const Dungeon& dungeon, const Point<float>& chunkSize);
+
+    bool Rasterize(Entry& entry, const Dungeon& dungeon, const Point<float>& chunkSize);
+
+    // drops entries from the back, but never the first keep ones
+    void Trim(const size_t keep);
+
+    RendererDungeon& mRendererDungeon;
+
+    size_t mCapacity {};
+    float mZoomStep {};
+    float mZoomBucket {};
+
+    // most recently used first
+    list<Entry> mEntries {};
+    unordered_map<uint64_t, list<Entry>::iterator> mIndex {};
+
+    vector<pair<Point<int32_t>, Dungeon*>> mChunks {};
+
+    Statistics mStatistics {};
+};
\ No newline at end of file
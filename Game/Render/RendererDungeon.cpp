@@ -0,0 +1,174 @@
+#include "Game/pch.h"
+#include "Engine/Utility/Profiler.h"
+#include "RendererDungeon.h"
+
+RendererDungeon::RendererDungeon(SDL_Renderer* renderer)
+    : mRenderer(renderer) {}
+
+void RendererDungeon::Render(
+    const Dungeon& dungeon,
+    const Point<float>& scale /* = { 1.f, 1.f } */,
+    const Point<float>& offset /* = {} */
+) {
+    Render(dungeon, dungeon.GetCanvas(), scale, offset);
+}
+
+void RendererDungeon::Render(
+    const Dungeon& dungeon,
+    const Rectangle<float>& visible,
+    const Point<float>& scale /* = { 1.f, 1.f } */,
+    const Point<float>& offset /* = {} */
+) {
+    PROFILE_SCOPE("RendererDungeon::Render");
+
+    auto isCurrent = IsBatchCurrent(visible, offset);
+    isCurrent = IsBatchCurrent(dungeon, 0) && isCurrent;
+    mBatchDungeons.resize(1);
+
+    if (!isCurrent) {
+        mBatch.clear();
+        mBatchStatistics = {};
+
+        AddToBatch(dungeon, visible, offset);
+    }
+
+    RenderBatch(scale);
+}
+
+void RendererDungeon::Render(
+    World& world,
+    const Point<float>& viewport,
+    const Point<float>& scale /* = { 1.f, 1.f } */,
+    const Point<float>& offset /* = {} */
+) {
+    PROFILE_SCOPE("RendererDungeon::Render");
+
+    const auto area = GetVisible(viewport, scale, offset);
+    world.GetChunks(area, mChunks);
+
+    auto isCurrent = IsBatchCurrent(area, offset);
+    for (size_t i = 0; i < mChunks.size(); i++) {
+        isCurrent = IsBatchCurrent(*mChunks[i].second, i) && isCurrent;
+    }
+    mBatchDungeons.resize(mChunks.size());
+
+    if (!isCurrent) {
+        mBatch.clear();
+        mBatchStatistics = {};
+
+        for (const auto& [chunk, dungeon] : mChunks) {
+            // chunks on the border of the view are only partly inside it
+            const auto origin = world.GetChunkOrigin(chunk);
+            const Rectangle<float> visible { area.GetX() - origin.GetX(), area.GetY() - origin.GetY(),
+                                             area.GetW(), area.GetH() };
+
+            AddToBatch(*dungeon, visible, offset + origin);
+        }
+    }
+
+    RenderBatch(scale);
+}
+
+Rectangle<float> RendererDungeon::GetVisible(
+    const Point<float>& viewport,
+    const Point<float>& scale /* = { 1.f, 1.f } */,
+    const Point<float>& offset /* = {} */
+) {
+    // a pixel p shows the world at p / scale - offset
+    return { -offset.GetX(), -offset.GetY(), viewport.GetX() / scale.GetX(), viewport.GetY() / scale.GetY() };
+}
+
+SDL_Renderer* RendererDungeon::GetRenderer() const {
+    return mRenderer;
+}
+
+const RendererDungeon::Statistics& RendererDungeon::GetStatistics() const {
+    return mStatistics;
+}
+
+void RendererDungeon::ResetStatistics() {
+    mStatistics = {};
+}
+
+void RendererDungeon::Invalidate() {
+    mBatchIsValid = false;
+}
+
+bool RendererDungeon::IsBatchCurrent(const Rectangle<float>& area, const Point<float>& offset) {
+    const auto isCurrent = mBatchIsValid && mBatchArea == area && mBatchOffset == offset;
+
+    mBatchIsValid = true;
+    mBatchArea = area;
+    mBatchOffset = offset;
+
+    return isCurrent;
+}
+
+bool RendererDungeon::IsBatchCurrent(const Dungeon& dungeon, const size_t index) {
+    // a chunk evicted and generated again may land at the same address, the seed tells them apart
+    const pair<const Dungeon*, uint64_t> key { &dungeon, dungeon.GetSeed() };
+
+    if (index < mBatchDungeons.size() && mBatchDungeons[index] == key) {
+        return true;
+    }
+
+    mBatchDungeons.resize(max(mBatchDungeons.size(), index + 1));
+    mBatchDungeons[index] = key;
+
+    return false;
+}
+
+void RendererDungeon::AddToBatch(const Dungeon& dungeon, const Rectangle<float>& visible, const Point<float>& offset) {
+    mRooms.clear();
+    mPaths.clear();
+    dungeon.GetRoomsIn(visible, mRooms);
+    dungeon.GetPathsIn(visible, mPaths);
+
+    mBatchStatistics.drawn += mRooms.size() + mPaths.size();
+    mBatchStatistics.culled += dungeon.GetRooms().size() + dungeon.GetPaths().size() - mRooms.size() - mPaths.size();
+
+    // rooms go last so they cover the ends of the paths leading into them
+    for (const auto path : mPaths) {
+        mBatch.push_back(ToFRect(dungeon.GetPaths()[path].GetRectangle(), offset));
+    }
+
+    for (const auto room : mRooms) {
+        mBatch.push_back(ToFRect(dungeon.GetRooms()[room].GetRectangle(), offset));
+    }
+}
+
+void RendererDungeon::RenderBatch(const Point<float>& scale) {
+    mStatistics.drawn += mBatchStatistics.drawn;
+    mStatistics.culled += mBatchStatistics.culled;
+
+    if (mBatch.empty()) {
+        return;
+    }
+
+    SDL_FPoint scaleLast {};
+    SDL_RenderGetScale(mRenderer, &scaleLast.x, &scaleLast.y);
+
+    SDL_RenderSetScale(mRenderer, scale.GetX(), scale.GetY());
+    SDL_RenderFillRectsF(mRenderer, mBatch.data(), (int)mBatch.size());
+    SDL_RenderSetScale(mRenderer, scaleLast.x, scaleLast.y);
+}
+
+void RendererDungeon::RenderRectangle(const Rectangle<float>& rectangle, const Point<float>& offset /* = {} */) const {
+    const auto frect = ToFRect(rectangle, offset);
+    SDL_RenderDrawRectF(mRenderer, &frect);
+}
+
+void RendererDungeon::RenderTree(const Dungeon& dungeon, const Point<float>& offset /* = {} */) const {
+    const auto& tree = dungeon.GetTree();
+
+    for (size_t i = 0; i < tree.GetSize(); i++) {
+        if (tree[i].IsUsed()) {
+            RenderRectangle(tree[i].GetLeaf(), offset);
+        }
+    }
+}
+
+SDL_FRect RendererDungeon::ToFRect(const Rectangle<float>& rectangle, const Point<float>& offset) {
+    return { rectangle.GetX() + offset.GetX(), rectangle.GetY() + offset.GetY(),
+             rectangle.GetW(), rectangle.GetH() };
+}
\ No newline at end of file
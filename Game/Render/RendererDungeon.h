@@ -0,0 +1,92 @@
+#pragma once
+
+#include "SDL.h"
+
+#include "Game/Generation/World.h"
+
+// Draws dungeons with SDL. The generation code only produces rectangles, so this adapter is
+// the one piece that has to change when the game draws them some other way.
+class RendererDungeon {
+public:
+    // rooms and paths handled since the last ResetStatistics
+    struct Statistics {
+        size_t drawn {};
+        size_t culled {};
+    };
+
+    RendererDungeon(SDL_Renderer* renderer);
+
+    void Render(
+        const Dungeon& dungeon,
+        const Point<float>& scale = { 1.f, 1.f },
+        const Point<float>& offset = {}
+    );
+
+    // Renders only what overlaps visible, given in the coordinates of the dungeon
+    void Render(
+        const Dungeon& dungeon,
+        const Rectangle<float>& visible,
+        const Point<float>& scale = { 1.f, 1.f },
+        const Point<float>& offset = {}
+    );
+
+    // Renders only the chunks seen through a viewport of the given size in pixels
+    void Render(
+        World& world,
+        const Point<float>& viewport,
+        const Point<float>& scale = { 1.f, 1.f },
+        const Point<float>& offset = {}
+    );
+
+    // the part of the world a viewport of the given size in pixels shows
+    static Rectangle<float> GetVisible(
+        const Point<float>& viewport,
+        const Point<float>& scale = { 1.f, 1.f },
+        const Point<float>& offset = {}
+    );
+
+    SDL_Renderer* GetRenderer() const;
+
+    const Statistics& GetStatistics() const;
+
+    void ResetStatistics();
+
+    // Forces the next Render to rebuild its rectangles, for callers that change a dungeon in place
+    void Invalidate();
+
+private:
+    // whether the batch was built for this very view, updating what it remembers if not
+    bool IsBatchCurrent(const Rectangle<float>& area, const Point<float>& offset);
+
+    bool IsBatchCurrent(const Dungeon& dungeon, const size_t index);
+
+    void AddToBatch(const Dungeon& dungeon, const Rectangle<float>& visible, const Point<float>& offset);
+
+    void RenderBatch(const Point<float>& scale);
+
+    void RenderRectangle(const Rectangle<float>& rectangle, const Point<float>& offset = {}) const;
+
+    void RenderTree(const Dungeon& dungeon, const Point<float>& offset = {}) const;
+
+    static SDL_FRect ToFRect(const Rectangle<float>& rectangle, const Point<float>& offset);
+
+    SDL_Renderer* mRenderer = nullptr;
+
+    vector<pair<Point<int32_t>, Dungeon*>> mChunks {};
+
+    // reused between frames, so culling allocates nothing once they have grown
+    vector<size_t> mRooms {};
+    vector<size_t> mPaths {};
+
+    // Everything visible, offset and ready for one SDL_RenderFillRectsF. It is kept while the
+    // view and the dungeons in it stay the same, which is most frames.
+    vector<SDL_FRect> mBatch {};
+    Statistics mBatchStatistics {};
+
+    bool mBatchIsValid = false;
+    Rectangle<float> mBatchArea {};
+    Point<float> mBatchOffset {};
+    vector<pair<const Dungeon*, uint64_t>> mBatchDungeons {};
+
+    Statistics mStatistics {};
+};
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "Game/pch.h"
+#include "Engine/Utility/Profiler.h"
+#include "RendererDungeon.h"
+#include "RendererTileMatrix.h"
+
+RendererTileMatrix::RendererTileMatrix(SDL_Renderer* renderer)
+    : mRenderer(renderer) {}
+
+void RendererTileMatrix::SetTexture(
+    const Dungeon::Tile tile,
+    SDL_Texture* texture,
+    const SDL_Color& color /* = { 255, 255, 255, 255 } */,
+    const SDL_FRect& coordinates /* = { 0.f, 0.f, 1.f, 1.f } */
+) {
+    mAppearances[(size_t)tile] = { texture, color, coordinates };
+}
+
+void RendererTileMatrix::Render(
+    const Matrix<Dungeon::Tile>& tileMatrix,
+    const float tileSize,
+    const Rectangle<float>& visible,
+    const Point<float>& scale /* = { 1.f, 1.f } */,
+    const Point<float>& offset /* = {} */
+) {
+    PROFILE_SCOPE("RendererTileMatrix::Render");
+
+    BeginBatches();
+    AddTiles(tileMatrix, tileSize, visible, scale, offset);
+    RenderBatches();
+}
+
+void RendererTileMatrix::Render(
+    World& world,
+    const Point<float>& viewport,
+    const Point<float>& scale /* = { 1.f, 1.f } */,
+    const Point<float>& offset /* = {} */
+) {
+    PROFILE_SCOPE("RendererTileMatrix::Render");
+
+    const auto area = RendererDungeon::GetVisible(viewport, scale, offset);
+    world.GetChunks(area, mChunks);
+
+    for (auto& [key, chunk] : mTileMatrices) {
+        chunk.isVisible = false;
+    }
+
+    BeginBatches();
+
+    for (const auto& [coordinates, dungeon] : mChunks) {
+        const auto key = ((uint64_t)(uint32_t)coordinates.GetX() << 32) | (uint32_t)coordinates.GetY();
+        const pair<const Dungeon*, uint64_t> dungeonKey { dungeon, dungeon->GetSeed() };
+
+        auto& chunk = mTileMatrices[key];
+        if (chunk.dungeon != dungeonKey) {
+            chunk.dungeon = dungeonKey;
+            dungeon->GenerateTileMatrix(chunk.tileMatrix);
+        }
+        chunk.isVisible = true;
+
+        const auto origin = world.GetChunkOrigin(coordinates);
+        const Rectangle<float> visible { area.GetX() - origin.GetX(), area.GetY() - origin.GetY(),
+                                         area.GetW(), area.GetH() };
+
+        AddTiles(chunk.tileMatrix, dungeon->GetTileSize(), visible, scale, offset + origin);
+    }
+
+    RenderBatches();
+
+    // matrices are cheap to generate again, so only the chunks in view keep theirs
+    for (auto iterator = mTileMatrices.begin(); iterator != mTileMatrices.end();) {
+        iterator = iterator->second.isVisible ? next(iterator) : mTileMatrices.erase(iterator);
+    }
+}
+
+SDL_Renderer* RendererTileMatrix::GetRenderer() const {
+    return mRenderer;
+}
+
+const RendererTileMatrix::Statistics& RendererTileMatrix::GetStatistics() const {
+    return mStatistics;
+}
+
+void RendererTileMatrix::BeginBatches() {
+    mStatistics = {};
+
+    // the vertices keep their capacity from the last frame
+    for (auto& batch : mBatches) {
+        batch.texture = nullptr;
+        batch.vertices.clear();
+    }
+
+    size_t batches = 0;
+    for (size_t i = 0; i < mTileCount; i++) {
+        const auto texture = mAppearances[i].texture;
+
+        size_t batch = 0;
+        while (batch < batches && mBatches[batch].texture != texture) {
+            batch++;
+        }
+
+        if (batch == batches) {
+            if (batches == mBatches.size()) {
+                mBatches.emplace_back();
+            }
+
+            mBatches[batches++].texture = texture;
+        }
+
+        mBatchOfTile[i] = batch;
+    }
+}
+
+void RendererTileMatrix::AddTiles(
+    const Matrix<Dungeon::Tile>& tileMatrix,
+    const float tileSize,
+    const Rectangle<float>& visible,
+    const Point<float>& scale,
+    const Point<float>& offset
+) {
+    // clamped in floats first, the visible area may start far before the matrix
+    const auto clampTile = [](const float tile, const size_t count) {
+        return (size_t)clamp(tile, 0.f, (float)count);
+    };
+
+    const auto xFirst = clampTile(floor(visible.GetX() / tileSize), tileMatrix.GetWidth());
+    const auto xLast = clampTile(ceil((visible.GetX() + visible.GetW()) / tileSize), tileMatrix.GetWidth());
+    const auto yFirst = clampTile(floor(visible.GetY() / tileSize), tileMatrix.GetHeight());
+    const auto yLast = clampTile(ceil((visible.GetY() + visible.GetH()) / tileSize), tileMatrix.GetHeight());
+
+    const auto w = tileSize * scale.GetX();
+    const auto h = tileSize * scale.GetY();
+
+    for (auto y = yFirst; y < yLast; y++) {
+        const auto* row = tileMatrix[y];
+        const auto top = ((float)y * tileSize + offset.GetY()) * scale.GetY();
+
+        for (auto x = xFirst; x < xLast; x++) {
+            const auto tile = (size_t)row[x];
+
+            const auto& appearance = mAppearances[tile];
+            if (!appearance.texture) {
+                continue;
+            }
+
+            const auto left = ((float)x * tileSize + offset.GetX()) * scale.GetX();
+
+            const auto& uv = appearance.coordinates;
+
+            auto& vertices = mBatches[mBatchOfTile[tile]].vertices;
+            vertices.push_back({ { left, top }, appearance.color, { uv.x, uv.y } });
+            vertices.push_back({ { left + w, top }, appearance.color, { uv.x + uv.w, uv.y } });
+            vertices.push_back({ { left, top + h }, appearance.color, { uv.x, uv.y + uv.h } });
+            vertices.push_back({ { left + w, top + h }, appearance.color, { uv.x + uv.w, uv.y + uv.h } });
+
+            mStatistics.tiles++;
+        }
+    }
+}
+
+void RendererTileMatrix::RenderBatches() {
+    for (const auto& batch : mBatches) {
+        if (!batch.texture || batch.vertices.empty()) {
+            continue;
+        }
+
+        const auto quads = batch.vertices.size() / 4;
+        for (auto quad = mIndices.size() / 6; quad < quads; quad++) {
+            const auto first = (int)(quad * 4);
+            mIndices.insert(mIndices.end(), { first, first + 1, first + 2, first + 2, first + 1, first + 3 });
+        }
+
+        SDL_RenderGeometry(mRenderer, batch.texture, batch.vertices.data(), (int)batch.vertices.size(),
+                           mIndices.data(), (int)(quads * 6));
+        mStatistics.batches++;
+    }
+}
\ No newline at end of file
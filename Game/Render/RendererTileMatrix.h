@@ -0,0 +1,100 @@
+#pragma once
+
+#include "SDL.h"
+
+#include "Game/Generation/World.h"
+
+#include <unordered_map>
+
+// Draws tile matrices with textures. The visible tiles of every matrix handed to one Render go
+// into a vertex batch per texture, so a frame costs one SDL_RenderGeometry per texture however
+// many tiles and chunks it shows.
+class RendererTileMatrix {
+public:
+    // what the last Render did
+    struct Statistics {
+        size_t tiles {};
+        size_t batches {};
+    };
+
+    RendererTileMatrix(SDL_Renderer* renderer);
+
+    // Tiles of this kind are drawn with the part of texture at coordinates (0 to 1) tinted by color,
+    // a null texture hides them. Tiles from one atlas page share a batch.
+    void SetTexture(
+        const Dungeon::Tile tile,
+        SDL_Texture* texture,
+        const SDL_Color& color = { 255, 255, 255, 255 },
+        const SDL_FRect& coordinates = { 0.f, 0.f, 1.f, 1.f }
+    );
+
+    // Renders the tiles overlapping visible, given in the coordinates of the matrix
+    void Render(
+        const Matrix<Dungeon::Tile>& tileMatrix,
+        const float tileSize,
+        const Rectangle<float>& visible,
+        const Point<float>& scale = { 1.f, 1.f },
+        const Point<float>& offset = {}
+    );
+
+    // Renders the tiles of the chunks seen through a viewport of the given size in pixels
+    void Render(
+        World& world,
+        const Point<float>& viewport,
+        const Point<float>& scale = { 1.f, 1.f },
+        const Point<float>& offset = {}
+    );
+
+    SDL_Renderer* GetRenderer() const;
+
+    const Statistics& GetStatistics() const;
+
+private:
+    static constexpr size_t mTileCount = 3;
+
+    struct Appearance {
+        SDL_Texture* texture = nullptr;
+        SDL_Color color { 255, 255, 255, 255 };
+        SDL_FRect coordinates { 0.f, 0.f, 1.f, 1.f };
+    };
+
+    struct Batch {
+        SDL_Texture* texture = nullptr;
+        vector<SDL_Vertex> vertices {};
+    };
+
+    // the matrix of a chunk, generated again once the world replaces the dungeon behind it
+    struct Chunk {
+        pair<const Dungeon*, uint64_t> dungeon {};
+        Matrix<Dungeon::Tile> tileMatrix {};
+        bool isVisible {};
+    };
+
+    void BeginBatches();
+
+    void AddTiles(
+        const Matrix<Dungeon::Tile>& tileMatrix,
+        const float tileSize,
+        const Rectangle<float>& visible,
+        const Point<float>& scale,
+        const Point<float>& offset
+    );
+
+    void RenderBatches();
+
+    SDL_Renderer* mRenderer = nullptr;
+
+    Appearance mAppearances[mTileCount] {};
+
+    // which batch every kind of tile goes to, tiles sharing a texture share a batch
+    size_t mBatchOfTile[mTileCount] {};
+    vector<Batch> mBatches {};
+
+    // two triangles per tile, the same for every batch so it is only ever grown
+    vector<int> mIndices {};
+
+    vector<pair<Point<int32_t>, Dungeon*>> mChunks {};
+    unordered_map<uint64_t, Chunk> mTileMatrices {};
+
+    Statistics mStatistics {};
+};
\ No newline at end of file
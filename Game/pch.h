@@ -8,10 +8,15 @@ using namespace std;
 #include "Engine/Utility/Random.h"
 
 // ATL
+#include <algorithm>
+#include <vector>
 #include <list>
+#include <queue>
 
 #include <limits>
 #include <cmath>
 
-// SDL
-#include "SDL.h"
+// ATL IO
+#include <iostream>
+#include <fstream>
+#include <sstream>